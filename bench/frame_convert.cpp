@@ -0,0 +1,63 @@
+// Micro-benchmark for the frame conversion kernels.
+// Build with `scons bench` and run `bin/bench/frame_convert`.
+
+#include "frame_convert.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace BlipKit;
+
+static constexpr uint32_t CHANNEL_COUNT = 2;
+static constexpr uint32_t BLOCK_SIZES[] = { 256, 512, 1024, 4096 };
+static constexpr uint32_t FRAMES_PER_RUN = 1 << 26;
+
+int main() {
+	const FrameConverter *converters = nullptr;
+	const uint32_t converter_count = get_frame_converters(&converters);
+
+	printf("selected: %s\n", get_frame_converter().name);
+	printf("%-8s %8s %12s %12s\n", "kernel", "frames", "ns/frame", "Mframes/s");
+
+	for (const uint32_t block_size : BLOCK_SIZES) {
+		const uint32_t value_count = block_size * CHANNEL_COUNT;
+		std::vector<BKFrame> source(value_count);
+		std::vector<float> reference(value_count);
+		// Destination with source in upper half, as used by the mixer.
+		std::vector<float> buffer(value_count);
+
+		for (BKFrame &value : source) {
+			value = BKFrame(rand());
+		}
+
+		converters[0].convert(source.data(), reference.data(), value_count);
+
+		for (uint32_t i = 0; i < converter_count; i++) {
+			const FrameConverter &converter = converters[i];
+			const uint32_t runs = FRAMES_PER_RUN / block_size;
+			BKFrame *upper_half = reinterpret_cast<BKFrame *>(buffer.data() + value_count / 2);
+
+			const auto start = std::chrono::steady_clock::now();
+
+			for (uint32_t run = 0; run < runs; run++) {
+				memcpy(upper_half, source.data(), value_count * sizeof(BKFrame));
+				converter.convert(upper_half, buffer.data(), value_count);
+			}
+
+			const auto end = std::chrono::steady_clock::now();
+			const double seconds = std::chrono::duration<double>(end - start).count();
+			const double frames = double(runs) * double(block_size);
+
+			if (memcmp(buffer.data(), reference.data(), value_count * sizeof(float)) != 0) {
+				fprintf(stderr, "%s: result differs from scalar conversion\n", converter.name);
+				return EXIT_FAILURE;
+			}
+
+			printf("%-8s %8u %12.3f %12.1f\n", converter.name, block_size, seconds * 1e9 / frames, frames / seconds * 1e-6);
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,199 @@
+// Benchmark for the mixing hot path.
+// Build with `scons bench` and run `bin/bench/mix`. Results are written as JSON.
+//
+// The extension classes need a running engine, so this benchmark uses the BlipKit
+// API directly and mirrors what `AudioStreamBlipKitPlayback::generate_frames`
+// does: generate into the upper half of the output buffer and convert in place.
+
+#include "frame_convert.hpp"
+#include <BlipKit.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace BlipKit;
+
+static constexpr BKInt SAMPLE_RATE = BK_DEFAULT_SAMPLE_RATE;
+static constexpr BKInt CHANNEL_COUNT = 2;
+static constexpr BKInt BLOCK_SIZE = 512;
+static constexpr double WARMUP_SECONDS = 0.5;
+static constexpr double MEASURE_SECONDS = 10.0;
+static constexpr double TAU = 6.283185307179586;
+
+static constexpr int TRACK_COUNTS[] = { 1, 8, 32, 128 };
+
+enum Waveform {
+	WAVEFORM_SQUARE,
+	WAVEFORM_NOISE,
+	WAVEFORM_CUSTOM,
+	WAVEFORM_SAMPLE,
+	WAVEFORM_MAX,
+};
+
+static const char *WAVEFORM_NAMES[WAVEFORM_MAX] = {
+	"square",
+	"noise",
+	"custom",
+	"sample",
+};
+
+struct Result {
+	double generate_ns = 0.0;
+	double convert_ns = 0.0;
+	double frames = 0.0;
+};
+
+class Bench {
+private:
+	BKContext context;
+	BKData custom_waveform;
+	BKData sample;
+	std::vector<BKTrack> tracks;
+	std::vector<BKFrame> waveform_frames;
+	std::vector<BKFrame> sample_frames;
+	std::vector<float> buffer;
+
+	void init_data() {
+		BKDataInit(&custom_waveform);
+		BKDataInit(&sample);
+
+		// Saw-like custom waveform.
+		waveform_frames.resize(32);
+		for (uint32_t i = 0; i < waveform_frames.size(); i++) {
+			waveform_frames[i] = BKFrame((int(i) - 16) * (BK_FRAME_MAX / 16));
+		}
+		BKDataSetFrames(&custom_waveform, waveform_frames.data(), waveform_frames.size(), 1, false);
+
+		// One second of a decaying sine.
+		sample_frames.resize(SAMPLE_RATE);
+		for (uint32_t i = 0; i < sample_frames.size(); i++) {
+			const double t = double(i) / double(SAMPLE_RATE);
+			sample_frames[i] = BKFrame(sin(t * 440.0 * TAU) * exp(-t * 3.0) * double(BK_FRAME_MAX));
+		}
+		BKDataSetFrames(&sample, sample_frames.data(), sample_frames.size(), 1, false);
+	}
+
+	void init_track(BKTrack *p_track, int p_index, Waveform p_waveform, bool p_effects) {
+		BKTrackInit(p_track, p_waveform == WAVEFORM_NOISE ? BK_NOISE : BK_SQUARE);
+		BKTrackAttach(p_track, &context);
+
+		switch (p_waveform) {
+			case WAVEFORM_CUSTOM: {
+				BKSetPtr(p_track, BK_WAVEFORM, &custom_waveform, 0);
+			} break;
+			case WAVEFORM_SAMPLE: {
+				BKSetPtr(p_track, BK_SAMPLE, &sample, 0);
+				BKSetAttr(p_track, BK_SAMPLE_REPEAT, BK_REPEAT);
+			} break;
+			default: {
+				// Built-in waveform.
+			} break;
+		}
+
+		BKSetAttr(p_track, BK_MASTER_VOLUME, BK_MAX_VOLUME / 8);
+		BKSetAttr(p_track, BK_VOLUME, BK_MAX_VOLUME);
+
+		if (p_effects) {
+			BKInt vibrato[3] = { 24, BK_FINT20_UNIT / 2, 0 };
+			BKInt tremolo[3] = { 18, BK_MAX_VOLUME / 2, 0 };
+			BKInt arpeggio[4] = { 3, 0, 4 * BK_FINT20_UNIT, 7 * BK_FINT20_UNIT };
+
+			BKSetPtr(p_track, BK_EFFECT_VIBRATO, vibrato, sizeof(vibrato));
+			BKSetPtr(p_track, BK_EFFECT_TREMOLO, tremolo, sizeof(tremolo));
+			BKSetPtr(p_track, BK_ARPEGGIO, arpeggio, sizeof(arpeggio));
+		}
+
+		// Spread notes over a few octaves.
+		const BKInt note = BK_C_3 + (p_index * 7) % 36;
+		BKSetAttr(p_track, BK_NOTE, note * BK_FINT20_UNIT);
+	}
+
+	void mix(Result *r_result) {
+		BKFrame *frames = reinterpret_cast<BKFrame *>(buffer.data() + BLOCK_SIZE * CHANNEL_COUNT / 2);
+
+		const auto start = std::chrono::steady_clock::now();
+		const BKInt count = BKContextGenerate(&context, frames, BLOCK_SIZE);
+		const auto generated = std::chrono::steady_clock::now();
+		convert_frames(frames, buffer.data(), count * CHANNEL_COUNT);
+		const auto end = std::chrono::steady_clock::now();
+
+		if (r_result) {
+			r_result->generate_ns += std::chrono::duration<double, std::nano>(generated - start).count();
+			r_result->convert_ns += std::chrono::duration<double, std::nano>(end - generated).count();
+			r_result->frames += double(count);
+		}
+	}
+
+public:
+	Bench() {
+		buffer.resize(BLOCK_SIZE * CHANNEL_COUNT);
+		init_data();
+	}
+
+	~Bench() {
+		BKDispose(&custom_waveform);
+		BKDispose(&sample);
+	}
+
+	Result run(int p_track_count, Waveform p_waveform, bool p_effects) {
+		Result result;
+
+		BKContextInit(&context, CHANNEL_COUNT, SAMPLE_RATE);
+		tracks.resize(p_track_count);
+
+		for (int i = 0; i < p_track_count; i++) {
+			init_track(&tracks[i], i, p_waveform, p_effects);
+		}
+
+		for (int frames = 0; frames < int(WARMUP_SECONDS * SAMPLE_RATE); frames += BLOCK_SIZE) {
+			mix(nullptr);
+		}
+
+		for (int frames = 0; frames < int(MEASURE_SECONDS * SAMPLE_RATE); frames += BLOCK_SIZE) {
+			mix(&result);
+		}
+
+		for (BKTrack &track : tracks) {
+			BKDispose(&track);
+		}
+
+		BKDispose(&context);
+
+		return result;
+	}
+};
+
+int main() {
+	Bench bench;
+	bool first = true;
+
+	printf("{\n");
+	printf("\t\"sample_rate\": %d,\n", SAMPLE_RATE);
+	printf("\t\"block_size\": %d,\n", BLOCK_SIZE);
+	printf("\t\"frame_converter\": \"%s\",\n", get_frame_converter().name);
+	printf("\t\"results\": [");
+
+	for (const int track_count : TRACK_COUNTS) {
+		for (int waveform = 0; waveform < WAVEFORM_MAX; waveform++) {
+			for (const bool effects : { false, true }) {
+				const Result result = bench.run(track_count, Waveform(waveform), effects);
+				const double generate_ns = result.generate_ns / result.frames;
+				const double convert_ns = result.convert_ns / result.frames;
+				const double total_ns = generate_ns + convert_ns;
+				const double realtime_factor = 1e9 / (total_ns * double(SAMPLE_RATE));
+
+				printf("%s\n\t\t{ \"tracks\": %d, \"waveform\": \"%s\", \"effects\": %s, ", first ? "" : ",", track_count, WAVEFORM_NAMES[waveform], effects ? "true" : "false");
+				printf("\"generate_ns_per_frame\": %.3f, \"convert_ns_per_frame\": %.3f, \"ns_per_frame\": %.3f, \"realtime_factor\": %.1f }", generate_ns, convert_ns, total_ns, realtime_factor);
+				fflush(stdout);
+
+				first = false;
+			}
+		}
+	}
+
+	printf("\n\t]\n}\n");
+
+	return EXIT_SUCCESS;
+}
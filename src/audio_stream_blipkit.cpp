@@ -1,10 +1,53 @@
 #include "audio_stream_blipkit.hpp"
 #include "blipkit_track.hpp"
+#include "frame_convert.hpp"
+#include <algorithm>
+#include <chrono>
+#include <godot_cpp/classes/audio_server.hpp>
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+#include <thread>
 
 using namespace BlipKit;
 using namespace godot;
 
-RecursiveMutex AudioStreamBlipKit::mutex;
+#define BK_PLAYBACK_SAFE_METHOD MutexLock _mutex_lock_(mutex);
+
+static_assert(sizeof(AudioFrame) == sizeof(float) * 2, "AudioFrame must consist of two floats.");
+
+static const char *statistic_names[AudioStreamBlipKitPlayback::STAT_MAX] = {
+	"mix_count",
+	"mix_time_min",
+	"mix_time_avg",
+	"mix_time_max",
+	"mix_time_p99",
+	"lock_wait_avg",
+	"lock_wait_max",
+	"frames_generated",
+	"frames_zero_filled",
+	"sync_calls",
+	"tracks_active",
+	"tracks_parked",
+};
+
+static _ALWAYS_INLINE_ uint64_t get_time_nsec() {
+	const auto now = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+static bool is_zero_frames(const BKFrame *p_frames, uint32_t p_count) {
+	for (uint32_t i = 0; i < p_count; i++) {
+		if (p_frames[i] != 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+RecursiveMutex AudioStreamBlipKitPlayback::resource_mutex;
+LocalVector<AudioStreamBlipKitPlayback *> AudioStreamBlipKitPlayback::playbacks;
 
 AudioStreamBlipKit::AudioStreamBlipKit() {
 	set_local_to_scene(true);
@@ -17,7 +60,7 @@ Ref<AudioStreamBlipKitPlayback> AudioStreamBlipKit::get_playback() {
 
 	playback.instantiate();
 
-	if (not playback->initialize(clock_rate)) {
+	if (not playback->initialize(clock_rate, get_output_sample_rate(), sync_mode)) {
 		playback.unref();
 		ERR_FAIL_V_MSG(playback, "Could not initialize AudioStreamBlipKitPlayback.");
 	}
@@ -53,6 +96,45 @@ int AudioStreamBlipKit::get_clock_rate() const {
 	return clock_rate;
 }
 
+void AudioStreamBlipKit::set_sample_rate(int p_sample_rate) {
+	if (p_sample_rate != SAMPLE_RATE_AUTO) {
+		p_sample_rate = CLAMP(p_sample_rate, BK_MIN_SAMPLE_RATE, BK_MAX_SAMPLE_RATE);
+	}
+
+	sample_rate = p_sample_rate;
+
+	if (playback.is_valid()) {
+		playback->set_sample_rate(get_output_sample_rate());
+	}
+}
+
+int AudioStreamBlipKit::get_sample_rate() const {
+	return sample_rate;
+}
+
+void AudioStreamBlipKit::set_sync_mode(SyncMode p_sync_mode) {
+	ERR_FAIL_INDEX(p_sync_mode, 2);
+
+	sync_mode = p_sync_mode;
+
+	if (playback.is_valid()) {
+		playback->set_sync_mode(sync_mode);
+	}
+}
+
+AudioStreamBlipKit::SyncMode AudioStreamBlipKit::get_sync_mode() const {
+	return sync_mode;
+}
+
+int AudioStreamBlipKit::get_output_sample_rate() const {
+	if (sample_rate == SAMPLE_RATE_AUTO) {
+		const int mix_rate = int(AudioServer::get_singleton()->get_mix_rate());
+		return CLAMP(mix_rate, BK_MIN_SAMPLE_RATE, BK_MAX_SAMPLE_RATE);
+	}
+
+	return sample_rate;
+}
+
 void AudioStreamBlipKit::attach(BlipKitTrack *p_track) {
 	get_playback()->attach(p_track);
 }
@@ -61,60 +143,315 @@ void AudioStreamBlipKit::detach(BlipKitTrack *p_track) {
 	get_playback()->detach(p_track);
 }
 
-void AudioStreamBlipKit::call_synced(const Callable &p_callable) {
+void AudioStreamBlipKit::set_tracks_param(TrackParam p_param, const PackedInt32Array &p_track_ids, const PackedFloat32Array &p_values) {
+	ERR_FAIL_INDEX(p_param, TRACK_PARAM_MAX);
+	ERR_FAIL_COND_MSG(p_track_ids.size() != p_values.size(), "Track IDs and values must have the same size.");
+
+	get_playback()->set_tracks_param(p_param, p_track_ids, p_values);
+}
+
+PackedVector2Array AudioStreamBlipKit::render(double p_duration) {
+	return get_playback()->render(p_duration);
+}
+
+double AudioStreamBlipKit::get_render_frames_per_second() {
+	return get_playback()->render_frames_per_second;
+}
+
+void AudioStreamBlipKit::call_synced(const Callable &p_callable, const Callable &p_completed) {
+	ERR_FAIL_COND(not p_callable.is_valid());
+
+	get_playback()->call_synced(p_callable, p_completed);
+}
+
+void AudioStreamBlipKit::schedule(double p_time, const Callable &p_callable) {
 	ERR_FAIL_COND(not p_callable.is_valid());
 
-	get_playback()->call_synced(p_callable);
+	get_playback()->schedule(p_time, p_callable);
+}
+
+void AudioStreamBlipKit::schedule_param(double p_time, int32_t p_track_id, TrackParam p_param, float p_value) {
+	ERR_FAIL_INDEX(p_param, TRACK_PARAM_MAX);
+
+	get_playback()->schedule_param(p_time, p_track_id, p_param, p_value);
+}
+
+void AudioStreamBlipKit::clear_scheduled() {
+	get_playback()->clear_scheduled();
+}
+
+double AudioStreamBlipKit::get_time() {
+	return get_playback()->get_time();
 }
 
 void AudioStreamBlipKit::_bind_methods() {
-	ClassDB::bind_method(D_METHOD("call_synced", "callback"), &AudioStreamBlipKit::call_synced);
+	ClassDB::bind_method(D_METHOD("call_synced", "callback", "completed"), &AudioStreamBlipKit::call_synced, DEFVAL(Callable()));
+	ClassDB::bind_method(D_METHOD("schedule", "time", "callback"), &AudioStreamBlipKit::schedule);
+	ClassDB::bind_method(D_METHOD("schedule_param", "time", "track_id", "param", "value"), &AudioStreamBlipKit::schedule_param);
+	ClassDB::bind_method(D_METHOD("clear_scheduled"), &AudioStreamBlipKit::clear_scheduled);
+	ClassDB::bind_method(D_METHOD("get_time"), &AudioStreamBlipKit::get_time);
+	ClassDB::bind_method(D_METHOD("render", "duration"), &AudioStreamBlipKit::render);
+	ClassDB::bind_method(D_METHOD("get_render_frames_per_second"), &AudioStreamBlipKit::get_render_frames_per_second);
+	ClassDB::bind_method(D_METHOD("set_tracks_param", "param", "track_ids", "values"), &AudioStreamBlipKit::set_tracks_param);
 
 	ClassDB::bind_method(D_METHOD("set_clock_rate"), &AudioStreamBlipKit::set_clock_rate);
 	ClassDB::bind_method(D_METHOD("get_clock_rate"), &AudioStreamBlipKit::get_clock_rate);
+	ClassDB::bind_method(D_METHOD("set_sample_rate"), &AudioStreamBlipKit::set_sample_rate);
+	ClassDB::bind_method(D_METHOD("get_sample_rate"), &AudioStreamBlipKit::get_sample_rate);
+	ClassDB::bind_method(D_METHOD("set_sync_mode"), &AudioStreamBlipKit::set_sync_mode);
+	ClassDB::bind_method(D_METHOD("get_sync_mode"), &AudioStreamBlipKit::get_sync_mode);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "clock_rate", godot::PROPERTY_HINT_RANGE, vformat("%d,%d,1", CLOCK_RATE_MIN, CLOCK_RATE_MAX)), "set_clock_rate", "get_clock_rate");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "sample_rate", godot::PROPERTY_HINT_RANGE, vformat("%d,%d,1,suffix:Hz", SAMPLE_RATE_AUTO, BK_MAX_SAMPLE_RATE)), "set_sample_rate", "get_sample_rate");
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "sync_mode", PROPERTY_HINT_ENUM, "Audio,Deferred"), "set_sync_mode", "get_sync_mode");
+
+	BIND_CONSTANT(SAMPLE_RATE_AUTO);
+
+	BIND_ENUM_CONSTANT(SYNC_MODE_AUDIO);
+	BIND_ENUM_CONSTANT(SYNC_MODE_DEFERRED);
+
+	BIND_ENUM_CONSTANT(TRACK_PARAM_MASTER_VOLUME);
+	BIND_ENUM_CONSTANT(TRACK_PARAM_VOLUME);
+	BIND_ENUM_CONSTANT(TRACK_PARAM_PANNING);
+	BIND_ENUM_CONSTANT(TRACK_PARAM_NOTE);
+	BIND_ENUM_CONSTANT(TRACK_PARAM_PITCH);
+	BIND_ENUM_CONSTANT(TRACK_PARAM_SAMPLE_PITCH);
 }
 
 String AudioStreamBlipKit::_to_string() const {
 	return vformat("<AudioStreamBlipKit#%d>", get_instance_id());
 }
 
+AudioStreamBlipKitPlayback::ResourceLock::ResourceLock() {
+	const bool is_holding_playback = CountedRecursiveMutex::get_thread_lock_count() > 0;
+	int attempts = 0;
+
+	while (true) {
+		resource_mutex.lock();
+
+		uint32_t locked_count = 0;
+
+		for (; locked_count < playbacks.size(); locked_count++) {
+			if (not playbacks[locked_count]->mutex.try_lock()) {
+				break;
+			}
+		}
+
+		if (locked_count == playbacks.size()) [[likely]] {
+			locked = true;
+			return;
+		}
+
+		AudioStreamBlipKitPlayback *contended = playbacks[locked_count];
+
+		// Release all locks to avoid a deadlock with a thread holding a
+		// playback lock while binding a resource.
+		while (locked_count > 0) {
+			playbacks[--locked_count]->mutex.unlock();
+		}
+
+		// Retry without blocking, as the contended playback may wait for a
+		// playback locked by this thread.
+		if (is_holding_playback) {
+			resource_mutex.unlock();
+
+			if (++attempts >= HELD_LOCK_ATTEMPTS) {
+				return;
+			}
+
+			std::this_thread::yield();
+			continue;
+		}
+
+		// Wait until the contended playback is unlocked instead of retrying
+		// immediately. Counted before releasing the resource mutex so the
+		// playback is not freed while waiting.
+		contended->lock_waiters.fetch_add(1);
+		resource_mutex.unlock();
+
+		contended->mutex.lock();
+		contended->mutex.unlock();
+		contended->lock_waiters.fetch_sub(1);
+	}
+}
+
+AudioStreamBlipKitPlayback::ResourceLock::~ResourceLock() {
+	if (not locked) {
+		return;
+	}
+
+	for (uint32_t i = playbacks.size(); i > 0; i--) {
+		playbacks[i - 1]->mutex.unlock();
+	}
+
+	resource_mutex.unlock();
+}
+
 AudioStreamBlipKitPlayback::AudioStreamBlipKitPlayback() {
-	const BKInt result = BKContextInit(&context, CHANNEL_COUNT, SAMPLE_RATE);
+	MutexLock resource_lock(resource_mutex);
+	playbacks.push_back(this);
 
-	ERR_FAIL_COND_MSG(result != BK_SUCCESS, vformat("Failed to initialize BKContext: %s.", BKStatusGetName(result)));
+	const BKInt result = BKContextInit(&context, CHANNEL_COUNT, sample_rate);
 
-	const uint32_t buffer_size = CHANNEL_SIZE * CHANNEL_COUNT;
-	buffer.resize(buffer_size);
+	ERR_FAIL_COND_MSG(result != BK_SUCCESS, vformat("Failed to initialize BKContext: %s.", BKStatusGetName(result)));
 }
 
 AudioStreamBlipKitPlayback::~AudioStreamBlipKitPlayback() {
-	BK_THREAD_SAFE_METHOD
+	remove_performance_monitors();
 
-	active = false;
-	BKDispose(&context);
+	{
+		BK_PLAYBACK_SAFE_METHOD
 
-	for (BlipKitTrack *track : tracks) {
-		track->detach();
+		active = false;
+
+		// Tracks remove themselves when detaching and need the context to detach.
+		while (not tracks.is_empty()) {
+			tracks[tracks.size() - 1]->detach();
+		}
+
+		BKDispose(&context);
+
+		MutexLock resource_lock(resource_mutex);
+		playbacks.erase(this);
 	}
+
+	// Wait for `ResourceLock`s which started waiting before the playback was removed.
+	while (lock_waiters.load() > 0) {
+		std::this_thread::yield();
+	}
+}
+
+void AudioStreamBlipKitPlayback::set_offline() {
+	MutexLock resource_lock(resource_mutex);
+	playbacks.erase(this);
+}
+
+double AudioStreamBlipKitPlayback::get_statistic(Statistic p_statistic) const {
+	switch (p_statistic) {
+		case STAT_MIX_COUNT: {
+			return double(statistics.get_mix_count());
+		} break;
+		case STAT_MIX_TIME_MIN: {
+			return statistics.get_mix_time_min();
+		} break;
+		case STAT_MIX_TIME_AVG: {
+			return statistics.get_mix_time_avg();
+		} break;
+		case STAT_MIX_TIME_MAX: {
+			return statistics.get_mix_time_max();
+		} break;
+		case STAT_MIX_TIME_P99: {
+			return statistics.get_mix_time_p99();
+		} break;
+		case STAT_LOCK_WAIT_AVG: {
+			return statistics.get_lock_wait_avg();
+		} break;
+		case STAT_LOCK_WAIT_MAX: {
+			return statistics.get_lock_wait_max();
+		} break;
+		case STAT_FRAMES_GENERATED: {
+			return double(statistics.get_frames_generated());
+		} break;
+		case STAT_FRAMES_ZERO_FILLED: {
+			return double(statistics.get_frames_zero_filled());
+		} break;
+		case STAT_SYNC_CALLS: {
+			return double(statistics.get_sync_calls());
+		} break;
+		case STAT_TRACKS_ACTIVE: {
+			return double(active_track_count.load(std::memory_order_relaxed));
+		} break;
+		case STAT_TRACKS_PARKED: {
+			return double(parked_track_count.load(std::memory_order_relaxed));
+		} break;
+		default: {
+			ERR_FAIL_V_MSG(0.0, vformat("Invalid statistic: %d.", p_statistic));
+		} break;
+	}
+}
+
+Dictionary AudioStreamBlipKitPlayback::get_statistics() const {
+	Dictionary ret;
+
+	for (int i = 0; i < STAT_MAX; i++) {
+		ret[statistic_names[i]] = get_statistic(Statistic(i));
+	}
+
+	return ret;
+}
+
+void AudioStreamBlipKitPlayback::reset_statistics() {
+	statistics.reset();
+}
+
+void AudioStreamBlipKitPlayback::add_performance_monitors(const String &p_category) {
+	ERR_FAIL_COND(p_category.is_empty());
+
+	remove_performance_monitors();
+
+	Performance *performance = Performance::get_singleton();
+	monitor_category = p_category;
+
+	for (int i = 0; i < STAT_MAX; i++) {
+		const StringName id = vformat("%s/%s", monitor_category, statistic_names[i]);
+		performance->add_custom_monitor(id, callable_mp(this, &AudioStreamBlipKitPlayback::get_statistic), Array::make(i));
+	}
+}
+
+void AudioStreamBlipKitPlayback::remove_performance_monitors() {
+	if (monitor_category.is_empty()) {
+		return;
+	}
+
+	Performance *performance = Performance::get_singleton();
+
+	for (int i = 0; i < STAT_MAX; i++) {
+		const StringName id = vformat("%s/%s", monitor_category, statistic_names[i]);
+
+		if (performance->has_custom_monitor(id)) {
+			performance->remove_custom_monitor(id);
+		}
+	}
+
+	monitor_category = String();
 }
 
 void AudioStreamBlipKitPlayback::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_statistic", "statistic"), &AudioStreamBlipKitPlayback::get_statistic);
+	ClassDB::bind_method(D_METHOD("get_statistics"), &AudioStreamBlipKitPlayback::get_statistics);
+	ClassDB::bind_method(D_METHOD("reset_statistics"), &AudioStreamBlipKitPlayback::reset_statistics);
+	ClassDB::bind_method(D_METHOD("add_performance_monitors", "category"), &AudioStreamBlipKitPlayback::add_performance_monitors, DEFVAL("BlipKit"));
+	ClassDB::bind_method(D_METHOD("remove_performance_monitors"), &AudioStreamBlipKitPlayback::remove_performance_monitors);
+
+	BIND_ENUM_CONSTANT(STAT_MIX_COUNT);
+	BIND_ENUM_CONSTANT(STAT_MIX_TIME_MIN);
+	BIND_ENUM_CONSTANT(STAT_MIX_TIME_AVG);
+	BIND_ENUM_CONSTANT(STAT_MIX_TIME_MAX);
+	BIND_ENUM_CONSTANT(STAT_MIX_TIME_P99);
+	BIND_ENUM_CONSTANT(STAT_LOCK_WAIT_AVG);
+	BIND_ENUM_CONSTANT(STAT_LOCK_WAIT_MAX);
+	BIND_ENUM_CONSTANT(STAT_FRAMES_GENERATED);
+	BIND_ENUM_CONSTANT(STAT_FRAMES_ZERO_FILLED);
+	BIND_ENUM_CONSTANT(STAT_SYNC_CALLS);
+	BIND_ENUM_CONSTANT(STAT_TRACKS_ACTIVE);
+	BIND_ENUM_CONSTANT(STAT_TRACKS_PARKED);
 }
 
 String AudioStreamBlipKitPlayback::_to_string() const {
 	return vformat("<AudioStreamBlipKitPlayback#%d>", get_instance_id());
 }
 
-bool AudioStreamBlipKitPlayback::initialize(int p_clock_rate) {
+bool AudioStreamBlipKitPlayback::initialize(int p_clock_rate, int p_sample_rate, AudioStreamBlipKit::SyncMode p_sync_mode) {
+	set_sample_rate(p_sample_rate);
 	set_clock_rate(p_clock_rate);
+	set_sync_mode(p_sync_mode);
 
 	return true;
 }
 
 void AudioStreamBlipKitPlayback::set_clock_rate(int p_clock_rate) {
-	BK_THREAD_SAFE_METHOD
+	BK_PLAYBACK_SAFE_METHOD
 
 	clock_rate = CLAMP(p_clock_rate, AudioStreamBlipKit::CLOCK_RATE_MIN, AudioStreamBlipKit::CLOCK_RATE_MAX);
 
@@ -128,26 +465,641 @@ int AudioStreamBlipKitPlayback::get_clock_rate() const {
 	return clock_rate;
 }
 
-void AudioStreamBlipKitPlayback::call_synced(const Callable &p_callable) {
-	BK_THREAD_SAFE_METHOD
+void AudioStreamBlipKitPlayback::set_sample_rate(int p_sample_rate) {
+	BK_PLAYBACK_SAFE_METHOD
+
+	p_sample_rate = CLAMP(p_sample_rate, BK_MIN_SAMPLE_RATE, BK_MAX_SAMPLE_RATE);
 
+	if (p_sample_rate == sample_rate) {
+		return;
+	}
+
+	// The context has to be initialized again with the new sample rate.
+	for (BlipKitTrack *track : tracks) {
+		track->detach_context();
+	}
+
+	// Remaining dividers are attached by others (e.g., sequencers).
+	for (BKDivider *divider : dividers) {
+		BKDividerDetach(divider);
+	}
+
+	BKDispose(&context);
+	BKInt result = BKContextInit(&context, CHANNEL_COUNT, p_sample_rate);
+	is_silent = false;
+
+	if (result != BK_SUCCESS) [[unlikely]] {
+		ERR_PRINT(vformat("Failed to initialize BKContext: %s.", BKStatusGetName(result)));
+
+		// Keep the previous sample rate so attached tracks are attached again.
+		p_sample_rate = sample_rate;
+		result = BKContextInit(&context, CHANNEL_COUNT, p_sample_rate);
+
+		ERR_FAIL_COND_MSG(result != BK_SUCCESS, vformat("Failed to initialize BKContext: %s.", BKStatusGetName(result)));
+	}
+
+	// Keep stream time and scheduled events at the same time.
+	const uint64_t position = frame_position.load(std::memory_order_relaxed);
+	frame_position.store(position * p_sample_rate / sample_rate, std::memory_order_relaxed);
+
+	for (ScheduledEvent &event : scheduled_events) {
+		event.frame = event.frame * p_sample_rate / sample_rate;
+	}
+
+	sample_rate = p_sample_rate;
+	set_clock_rate(clock_rate);
+
+	for (BKDivider *divider : dividers) {
+		BKContextAttachDivider(&context, divider, BK_CLOCK_TYPE_BEAT);
+	}
+
+	for (BlipKitTrack *track : tracks) {
+		track->attach_context();
+	}
+}
+
+int AudioStreamBlipKitPlayback::get_sample_rate() const {
+	return sample_rate;
+}
+
+void AudioStreamBlipKitPlayback::set_sync_mode(AudioStreamBlipKit::SyncMode p_sync_mode) {
+	BK_PLAYBACK_SAFE_METHOD
+
+	sync_mode = p_sync_mode;
+}
+
+void AudioStreamBlipKitPlayback::call_synced(const Callable &p_callable, const Callable &p_completed) {
 	ERR_FAIL_COND(not p_callable.is_valid());
 
-	if (active && not is_calling_callbacks) {
-		sync_callables.push_back(p_callable);
-	} else {
+	// Changes of a callback called by another deferred callback are part of its recording.
+	if (recording_playback == this) {
 		p_callable.call();
+
+		if (p_completed.is_valid()) {
+			recording->completed_callables.push_back(p_completed);
+		}
+
+		return;
+	}
+
+	{
+		BK_PLAYBACK_SAFE_METHOD
+
+		if (not active || is_calling_callbacks) {
+			p_callable.call();
+
+			if (p_completed.is_valid()) {
+				p_completed.call();
+			}
+
+			return;
+		}
+
+		if (sync_mode == AudioStreamBlipKit::SYNC_MODE_AUDIO) {
+			sync_callables.push_back(p_callable);
+
+			if (p_completed.is_valid()) {
+				sync_completed_callables.push_back(p_completed);
+			}
+
+			return;
+		}
+	}
+
+	// Call the callback on this thread and record its track changes, which
+	// the audio thread then applies together at the next sample boundary.
+	SyncRecording recorded;
+	AudioStreamBlipKitPlayback *previous_playback = recording_playback;
+	SyncRecording *previous_recording = recording;
+
+	recording_playback = this;
+	recording = &recorded;
+
+	p_callable.call();
+	commit_recorded_commands();
+
+	recording_playback = previous_playback;
+	recording = previous_recording;
+
+	if (p_completed.is_valid()) {
+		recorded.completed_callables.push_back(p_completed);
+	}
+
+	if (not recorded.completed_callables.is_empty()) {
+		BK_PLAYBACK_SAFE_METHOD
+
+		for (const Callable &callable : recorded.completed_callables) {
+			sync_completed_callables.push_back(callable);
+		}
+	}
+}
+
+void AudioStreamBlipKitPlayback::call_sync_callables() {
+	if (not sync_callables.is_empty()) {
+		is_calling_callbacks = true;
+
+		for (const Callable &callable : sync_callables) {
+			callable.call();
+		}
+
+		is_calling_callbacks = false;
+		sync_callables.clear();
+	}
+
+	if (sync_completed_callables.is_empty()) {
+		return;
+	}
+
+	// Notify on the main thread after the changes have been applied.
+	for (const Callable &callable : sync_completed_callables) {
+		completed_callables.push_back(callable);
+	}
+
+	sync_completed_callables.clear();
+
+	if (not is_dispatch_pending) {
+		is_dispatch_pending = true;
+		callable_mp(this, &AudioStreamBlipKitPlayback::dispatch_synced).call_deferred();
+	}
+}
+
+void AudioStreamBlipKitPlayback::dispatch_synced() {
+	LocalVector<Callable> callables;
+
+	{
+		BK_PLAYBACK_SAFE_METHOD
+
+		callables = completed_callables;
+		completed_callables.clear();
+		is_dispatch_pending = false;
+	}
+
+	for (const Callable &callable : callables) {
+		callable.call();
+	}
+}
+
+bool AudioStreamBlipKitPlayback::record_command(const TrackCommand &p_command) {
+	if (recording_playback != this) {
+		return false;
+	}
+
+	recording->commands.push_back(p_command);
+
+	return true;
+}
+
+void AudioStreamBlipKitPlayback::commit_recorded_commands() {
+	if (recording_playback != this || recording->commands.is_empty()) {
+		return;
+	}
+
+	LocalVector<TrackCommand> &recorded = recording->commands;
+
+	BK_PLAYBACK_SAFE_METHOD
+
+	// Not enough space in the queue. Applying them while locked still keeps
+	// them within the same sample boundary.
+	if (not push_commands(recorded.ptr(), recorded.size())) {
+		flush_commands();
+
+		for (const TrackCommand &command : recorded) {
+			if (command.track->get_playback() == this) {
+				command.track->apply_command(command);
+			}
+		}
+	}
+
+	recorded.clear();
+}
+
+void AudioStreamBlipKitPlayback::schedule(double p_time, const Callable &p_callable) {
+	BK_PLAYBACK_SAFE_METHOD
+
+	ERR_FAIL_COND(not p_callable.is_valid());
+
+	ScheduledEvent event;
+	event.callable = p_callable;
+
+	push_scheduled_event(event, p_time);
+}
+
+void AudioStreamBlipKitPlayback::schedule_param(double p_time, int32_t p_track_id, AudioStreamBlipKit::TrackParam p_param, float p_value) {
+	BK_PLAYBACK_SAFE_METHOD
+
+	ScheduledEvent event;
+	event.track_id = p_track_id;
+	event.param = p_param;
+	event.value = p_value;
+
+	push_scheduled_event(event, p_time);
+}
+
+void AudioStreamBlipKitPlayback::push_scheduled_event(ScheduledEvent &p_event, double p_time) {
+	p_event.frame = uint64_t(MAX(p_time, 0.0) * double(sample_rate) + 0.5);
+	p_event.order = schedule_order++;
+
+	scheduled_events.push_back(p_event);
+	std::push_heap(scheduled_events.ptr(), scheduled_events.ptr() + scheduled_events.size(), ScheduledEvent::is_later);
+}
+
+void AudioStreamBlipKitPlayback::clear_scheduled() {
+	BK_PLAYBACK_SAFE_METHOD
+
+	scheduled_events.clear();
+}
+
+double AudioStreamBlipKitPlayback::get_time() const {
+	return double(frame_position.load(std::memory_order_relaxed)) / double(sample_rate);
+}
+
+void AudioStreamBlipKitPlayback::call_scheduled_events() {
+	const uint64_t position = frame_position.load(std::memory_order_relaxed);
+
+	is_calling_callbacks = true;
+
+	// Events may schedule new events.
+	while (not scheduled_events.is_empty() && scheduled_events[0].frame <= position) {
+		std::pop_heap(scheduled_events.ptr(), scheduled_events.ptr() + scheduled_events.size(), ScheduledEvent::is_later);
+		const ScheduledEvent event = scheduled_events[scheduled_events.size() - 1];
+		scheduled_events.remove_at(scheduled_events.size() - 1);
+
+		if (event.callable.is_valid()) {
+			event.callable.call();
+		} else {
+			BlipKitTrack *track = get_track(event.track_id);
+
+			// Ignore tracks which are not attached anymore.
+			if (track) {
+				set_track_param(track, event.param, event.value);
+			}
+		}
 	}
+
+	is_calling_callbacks = false;
 }
 
 void AudioStreamBlipKitPlayback::attach(BlipKitTrack *p_track) {
-	if (not tracks.has(p_track)) {
-		tracks.push_back(p_track);
+	if (p_track->track_index >= 0) {
+		return;
+	}
+
+	p_track->track_index = tracks.size();
+	p_track->parked = false;
+	p_track->parking = false;
+	tracks.push_back(p_track);
+	active_track_count.fetch_add(1, std::memory_order_relaxed);
+	is_silent = false;
+
+	uint32_t slot_index;
+
+	// Reuse slots of detached tracks.
+	if (not free_track_slots.is_empty()) {
+		slot_index = free_track_slots[free_track_slots.size() - 1];
+		free_track_slots.remove_at(free_track_slots.size() - 1);
+	} else {
+		ERR_FAIL_COND_MSG(track_slots.size() > TRACK_SLOT_MASK, "Too many tracks attached.");
+
+		slot_index = track_slots.size();
+		track_slots.push_back(TrackSlot());
 	}
+
+	TrackSlot &slot = track_slots[slot_index];
+	slot.track = p_track;
+	p_track->track_id = int((slot.generation << TRACK_SLOT_BITS) | slot_index);
 }
 
 void AudioStreamBlipKitPlayback::detach(BlipKitTrack *p_track) {
-	tracks.erase(p_track);
+	const int index = p_track->track_index;
+
+	if (index >= 0) {
+		ERR_FAIL_COND(index >= int(tracks.size()) || tracks[index] != p_track);
+
+		// Moves the last track into the gap.
+		tracks.remove_at_unordered(index);
+		p_track->track_index = -1;
+
+		if (p_track->parking) {
+			cancel_park_track(p_track);
+		}
+
+		if (p_track->parked) {
+			parked_track_count.fetch_sub(1, std::memory_order_relaxed);
+			p_track->parked = false;
+		} else {
+			active_track_count.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		if (index < int(tracks.size())) {
+			tracks[index]->track_index = index;
+		}
+	}
+
+	// Drop changes recorded for the track by a deferred sync callback.
+	if (recording_playback == this) {
+		LocalVector<TrackCommand> &recorded = recording->commands;
+
+		for (uint32_t i = 0; i < recorded.size();) {
+			if (recorded[i].track == p_track) {
+				recorded.remove_at(i);
+			} else {
+				i++;
+			}
+		}
+	}
+
+	if (p_track->track_id >= 0) {
+		const uint32_t slot_index = uint32_t(p_track->track_id) & TRACK_SLOT_MASK;
+		TrackSlot &slot = track_slots[slot_index];
+
+		// The ID of the detached track does not match the next track in this slot.
+		slot.track = nullptr;
+		slot.generation = (slot.generation + 1) & TRACK_GENERATION_MASK;
+		free_track_slots.push_back(slot_index);
+		p_track->track_id = -1;
+	}
+}
+
+void AudioStreamBlipKitPlayback::set_track_parked(bool p_parked) {
+	if (p_parked) {
+		active_track_count.fetch_sub(1, std::memory_order_relaxed);
+		parked_track_count.fetch_add(1, std::memory_order_relaxed);
+	} else {
+		parked_track_count.fetch_sub(1, std::memory_order_relaxed);
+		active_track_count.fetch_add(1, std::memory_order_relaxed);
+		is_silent = false;
+	}
+}
+
+void AudioStreamBlipKitPlayback::park_track_deferred(BlipKitTrack *p_track) {
+	p_track->parking = true;
+	parking_tracks.push_back(p_track);
+}
+
+void AudioStreamBlipKitPlayback::cancel_park_track(BlipKitTrack *p_track) {
+	p_track->parking = false;
+	parking_tracks.erase(p_track);
+}
+
+void AudioStreamBlipKitPlayback::attach_divider(BKDivider *p_divider) {
+	if (dividers.find(p_divider) >= 0) {
+		// Keep the divider if it was about to be detached.
+		detaching_dividers.erase(p_divider);
+		return;
+	}
+
+	// Dividers cannot be attached while the clock is ticking (e.g., when
+	// added by a divider callback of another track).
+	if (is_generating) {
+		if (attaching_dividers.find(p_divider) < 0) {
+			attaching_dividers.push_back(p_divider);
+		}
+
+		return;
+	}
+
+	BKContextAttachDivider(&context, p_divider, BK_CLOCK_TYPE_BEAT);
+	dividers.push_back(p_divider);
+}
+
+void AudioStreamBlipKitPlayback::detach_divider(BKDivider *p_divider) {
+	attaching_dividers.erase(p_divider);
+
+	const int64_t index = dividers.find(p_divider);
+
+	if (index < 0) {
+		return;
+	}
+
+	BKDividerDetach(p_divider);
+	dividers.remove_at_unordered(index);
+	detaching_dividers.erase(p_divider);
+}
+
+void AudioStreamBlipKitPlayback::detach_divider_deferred(BKDivider *p_divider) {
+	if (dividers.find(p_divider) < 0 || detaching_dividers.find(p_divider) >= 0) {
+		return;
+	}
+
+	detaching_dividers.push_back(p_divider);
+}
+
+BlipKitTrack *AudioStreamBlipKitPlayback::get_track(int32_t p_track_id) const {
+	const uint32_t slot_index = uint32_t(p_track_id) & TRACK_SLOT_MASK;
+
+	if (p_track_id < 0 || slot_index >= track_slots.size()) {
+		return nullptr;
+	}
+
+	const TrackSlot &slot = track_slots[slot_index];
+
+	// Ignore stale IDs of tracks detached from this slot.
+	if (slot.generation != uint32_t(p_track_id) >> TRACK_SLOT_BITS) {
+		return nullptr;
+	}
+
+	return slot.track;
+}
+
+void AudioStreamBlipKitPlayback::set_track_param(BlipKitTrack *p_track, AudioStreamBlipKit::TrackParam p_param, float p_value) {
+	switch (p_param) {
+		case AudioStreamBlipKit::TRACK_PARAM_MASTER_VOLUME: {
+			p_track->set_master_volume(p_value);
+		} break;
+		case AudioStreamBlipKit::TRACK_PARAM_VOLUME: {
+			p_track->set_volume(p_value);
+		} break;
+		case AudioStreamBlipKit::TRACK_PARAM_PANNING: {
+			p_track->set_panning(p_value);
+		} break;
+		case AudioStreamBlipKit::TRACK_PARAM_NOTE: {
+			p_track->set_note(p_value);
+		} break;
+		case AudioStreamBlipKit::TRACK_PARAM_PITCH: {
+			p_track->set_pitch(p_value);
+		} break;
+		case AudioStreamBlipKit::TRACK_PARAM_SAMPLE_PITCH: {
+			p_track->set_sample_pitch(p_value);
+		} break;
+		case AudioStreamBlipKit::TRACK_PARAM_MAX: {
+			ERR_FAIL();
+		} break;
+	}
+}
+
+void AudioStreamBlipKitPlayback::set_tracks_param(AudioStreamBlipKit::TrackParam p_param, const PackedInt32Array &p_track_ids, const PackedFloat32Array &p_values) {
+	BK_PLAYBACK_SAFE_METHOD
+
+	const int32_t *track_ids = p_track_ids.ptr();
+	const float *values = p_values.ptr();
+	const int64_t count = p_track_ids.size();
+
+	for (int64_t i = 0; i < count; i++) {
+		BlipKitTrack *track = get_track(track_ids[i]);
+
+		// Ignore tracks which are not attached anymore.
+		if (not track) {
+			continue;
+		}
+
+		set_track_param(track, p_param, values[i]);
+	}
+}
+
+bool AudioStreamBlipKitPlayback::push_command(const TrackCommand &p_command) {
+	// Apply directly when called from the audio thread (e.g., from a divider).
+	if (mixing_playback == this) {
+		return false;
+	}
+
+	return commands.push(p_command);
+}
+
+bool AudioStreamBlipKitPlayback::push_commands(const TrackCommand *p_commands, uint32_t p_count) {
+	if (mixing_playback == this) {
+		return false;
+	}
+
+	return commands.push_batch(p_commands, p_count);
+}
+
+void AudioStreamBlipKitPlayback::flush_commands() {
+	TrackCommand command;
+
+	while (commands.pop(command)) {
+		// Discard commands queued while the track was detaching.
+		if (command.track->get_playback() != this) [[unlikely]] {
+			continue;
+		}
+
+		command.track->apply_command(command);
+	}
+}
+
+int32_t AudioStreamBlipKitPlayback::generate_frames(AudioFrame *p_buffer, int32_t p_frames) {
+	const bool was_idle = active_track_count.load(std::memory_order_relaxed) == 0;
+
+	// Nothing is attached which could change the output. The context clock is
+	// not advanced as there are no dividers to call.
+	if (was_idle && is_silent && dividers.is_empty()) {
+		memset(p_buffer, 0, p_frames * sizeof(AudioFrame));
+		return p_frames;
+	}
+
+	// Generate into the upper half of the output buffer and convert in place.
+	float *out_buffer = reinterpret_cast<float *>(p_buffer);
+	BKFrame *frames = reinterpret_cast<BKFrame *>(out_buffer + p_frames);
+	int32_t count = 0;
+
+	is_generating = true;
+
+	while (count < p_frames) {
+		// Generate frames; produces no errors.
+		const BKInt chunk_size = BKContextGenerate(&context, &frames[count * CHANNEL_COUNT], p_frames - count);
+
+		// Nothing more to generate.
+		if (chunk_size <= 0) {
+			break;
+		}
+
+		count += chunk_size;
+	}
+
+	is_generating = false;
+
+	while (not detaching_dividers.is_empty()) {
+		detach_divider(detaching_dividers[detaching_dividers.size() - 1]);
+	}
+
+	while (not attaching_dividers.is_empty()) {
+		BKDivider *divider = attaching_dividers[attaching_dividers.size() - 1];
+		attaching_dividers.remove_at(attaching_dividers.size() - 1);
+		attach_divider(divider);
+	}
+
+	// The muted output of parking tracks has been generated.
+	for (BlipKitTrack *track : parking_tracks) {
+		track->park();
+	}
+
+	parking_tracks.clear();
+
+	// Dividers may have played a note while generating, which also clears `is_silent`.
+	const bool is_idle = was_idle && active_track_count.load(std::memory_order_relaxed) == 0;
+
+	if (is_idle && is_silent) {
+		// Skip converting the silent frames.
+		memset(p_buffer, 0, count * sizeof(AudioFrame));
+	} else {
+		// Parked tracks may leave a short tail in the output.
+		is_silent = is_idle && count > 0 && is_zero_frames(frames, count * CHANNEL_COUNT);
+		convert_frames(frames, out_buffer, count * CHANNEL_COUNT);
+	}
+
+	return count;
+}
+
+PackedVector2Array AudioStreamBlipKitPlayback::render(double p_duration) {
+	ERR_FAIL_COND_V(p_duration < 0.0, PackedVector2Array());
+
+	int64_t frame_count = 0;
+
+	{
+		BK_PLAYBACK_SAFE_METHOD
+
+		ERR_FAIL_COND_V_MSG(active, PackedVector2Array(), "Cannot render while the stream is playing.");
+		ERR_FAIL_COND_V_MSG(is_rendering, PackedVector2Array(), "Stream is already rendering.");
+
+		frame_count = int64_t(p_duration * double(sample_rate));
+		is_rendering = true;
+	}
+
+	const uint64_t start_ticks = Time::get_singleton()->get_ticks_usec();
+
+	PackedVector2Array frames;
+	frames.resize(frame_count);
+	Vector2 *ptrw = frames.ptrw();
+
+	// Lock each chunk separately so other threads can access the playback
+	// and its tracks while rendering.
+	for (int64_t offset = 0; offset < frame_count; offset += RENDER_CHUNK_SIZE) {
+		const int32_t chunk_size = int32_t(MIN(frame_count - offset, int64_t(RENDER_CHUNK_SIZE)));
+
+		// Let waiting threads take the lock first.
+		while (lock_waiters.load(std::memory_order_relaxed) > 0) {
+			std::this_thread::yield();
+		}
+
+		BK_PLAYBACK_SAFE_METHOD
+
+		if (active) [[unlikely]] {
+			is_rendering = false;
+			frames.resize(offset);
+			ERR_FAIL_V_MSG(frames, "Stream started playing while rendering.");
+		}
+
+		if constexpr (sizeof(Vector2) == sizeof(AudioFrame)) {
+			// Mix directly into the output.
+			mix_frames(reinterpret_cast<AudioFrame *>(&ptrw[offset]), chunk_size);
+		} else {
+			// Vector2 uses doubles.
+			AudioFrame buffer[RENDER_CHUNK_SIZE];
+			mix_frames(buffer, chunk_size);
+
+			for (int32_t i = 0; i < chunk_size; i++) {
+				ptrw[offset + i] = Vector2(buffer[i].left, buffer[i].right);
+			}
+		}
+	}
+
+	const uint64_t elapsed_usec = MAX(Time::get_singleton()->get_ticks_usec() - start_ticks, uint64_t(1));
+
+	BK_PLAYBACK_SAFE_METHOD
+
+	render_frames_per_second = double(frame_count) * 1e6 / double(elapsed_usec);
+	is_rendering = false;
+
+	return frames;
 }
 
 void AudioStreamBlipKitPlayback::_start(double p_from_pos) {
@@ -163,58 +1115,65 @@ bool AudioStreamBlipKitPlayback::_is_playing() const {
 }
 
 int32_t AudioStreamBlipKitPlayback::_mix_resampled(AudioFrame *p_buffer, int32_t p_frames) {
-	BK_THREAD_SAFE_METHOD
+	const uint64_t start_time = get_time_nsec();
+
+	BK_PLAYBACK_SAFE_METHOD
 
 	if (not active) {
 		return 0;
 	}
 
-	// Call sync callbacks.
-	if (not sync_callables.is_empty()) {
-		is_calling_callbacks = true;
+	const uint64_t lock_time = get_time_nsec();
+	const uint32_t sync_calls = sync_callables.size();
+	const int32_t out_count = mix_frames(p_buffer, p_frames);
+	const uint64_t end_time = get_time_nsec();
 
-		for (const Callable &callable : sync_callables) {
-			callable.call();
-		}
+	statistics.record_mix(end_time - start_time, lock_time - start_time, out_count, p_frames - out_count, sync_calls);
 
-		is_calling_callbacks = false;
-		sync_callables.clear();
-	}
+	return p_frames;
+}
+
+int32_t AudioStreamBlipKitPlayback::mix_frames(AudioFrame *p_buffer, int32_t p_frames) {
+	mixing_playback = this;
+
+	// Apply track changes made since the last call.
+	flush_commands();
+
+	call_sync_callables();
 
 	int32_t out_count = 0;
-	AudioFrame *out_buffer = p_buffer;
-	BKFrame *chunk_buffer = buffer.ptr();
-	constexpr float frame_scale = 1.0 / float(BK_FRAME_MAX);
 
+	// Split generation at scheduled events so changes land on the exact frame.
 	while (out_count < p_frames) {
-		BKInt chunk_size = MIN(p_frames - out_count, CHANNEL_SIZE);
+		call_scheduled_events();
 
-		// Generate frames; produces no errors.
-		chunk_size = BKContextGenerate(&context, chunk_buffer, chunk_size);
+		const uint64_t position = frame_position.load(std::memory_order_relaxed);
+		int32_t chunk_size = p_frames - out_count;
 
-		// Nothing more to generate.
-		if (chunk_size <= 0) {
-			break;
+		if (not scheduled_events.is_empty()) {
+			chunk_size = int32_t(MIN(scheduled_events[0].frame - position, uint64_t(chunk_size)));
 		}
 
-		// Fill output buffer.
-		for (uint32_t i = 0; i < chunk_size; i++) {
-			float left = float(buffer[i * CHANNEL_COUNT + 0]) * frame_scale;
-			float right = float(buffer[i * CHANNEL_COUNT + 1]) * frame_scale;
-			*out_buffer++ = { left, right };
-		}
+		const int32_t count = generate_frames(&p_buffer[out_count], chunk_size);
+		frame_position.store(position + count, std::memory_order_relaxed);
+		out_count += count;
 
-		out_count += chunk_size;
+		// Nothing more to generate.
+		if (count < chunk_size) {
+			break;
+		}
 	}
 
 	// Fill rest of output buffer if too few frames are generated.
-	for (; out_count < p_frames; out_count++) {
-		*out_buffer++ = { 0, 0 };
+	for (int32_t i = out_count; i < p_frames; i++) {
+		p_buffer[i] = { 0, 0 };
 	}
 
+	mixing_playback = nullptr;
+
 	return out_count;
 }
 
 double AudioStreamBlipKitPlayback::_get_stream_sampling_rate() const {
-	return double(SAMPLE_RATE);
+	return double(sample_rate);
 }
@@ -1,16 +1,26 @@
 #pragma once
 
+#include "command_queue.hpp"
+#include "mix_statistics.hpp"
 #include "mutex.hpp"
+#include "track_command.hpp"
 #include <BlipKit.h>
+#include <atomic>
 #include <godot_cpp/classes/audio_stream.hpp>
 #include <godot_cpp/classes/audio_stream_playback_resampled.hpp>
 #include <godot_cpp/templates/hash_map.hpp>
 #include <godot_cpp/templates/local_vector.hpp>
 #include <godot_cpp/variant/callable.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
 
 using namespace godot;
 
-#define BK_THREAD_SAFE_METHOD MutexLock _mutex_lock_ = AudioStreamBlipKit::mutex_lock();
+#define BK_RESOURCE_SAFE_METHOD                             \
+	AudioStreamBlipKitPlayback::ResourceLock _resource_lock_; \
+	ERR_FAIL_COND_MSG(not _resource_lock_.is_locked(), "Cannot modify a resource while another stream is locked by this thread.");
 
 namespace BlipKit {
 
@@ -25,17 +35,42 @@ private:
 	static constexpr int CLOCK_RATE_MIN = 60;
 	static constexpr int CLOCK_RATE_MAX = 960;
 
+public:
+	enum SyncMode {
+		SYNC_MODE_AUDIO,
+		SYNC_MODE_DEFERRED,
+	};
+
+	enum TrackParam {
+		TRACK_PARAM_MASTER_VOLUME,
+		TRACK_PARAM_VOLUME,
+		TRACK_PARAM_PANNING,
+		TRACK_PARAM_NOTE,
+		TRACK_PARAM_PITCH,
+		TRACK_PARAM_SAMPLE_PITCH,
+		TRACK_PARAM_MAX,
+	};
+
+	static constexpr int SAMPLE_RATE_AUTO = 0;
+
+private:
 	int clock_rate = BK_DEFAULT_CLOCK_RATE;
+	int sample_rate = BK_DEFAULT_SAMPLE_RATE;
+	SyncMode sync_mode = SYNC_MODE_AUDIO;
 	Ref<AudioStreamBlipKitPlayback> playback;
 
-	static RecursiveMutex mutex;
-
-	void set_clock_rate(int p_clock_rate);
-	int get_clock_rate() const;
+	int get_output_sample_rate() const;
 
 public:
 	AudioStreamBlipKit();
 
+	void set_clock_rate(int p_clock_rate);
+	int get_clock_rate() const;
+	void set_sample_rate(int p_sample_rate);
+	int get_sample_rate() const;
+	void set_sync_mode(SyncMode p_sync_mode);
+	SyncMode get_sync_mode() const;
+
 	Ref<AudioStreamPlayback> _instantiate_playback() const override;
 	String _get_stream_name() const override;
 
@@ -47,11 +82,16 @@ public:
 	void attach(BlipKitTrack *p_track);
 	void detach(BlipKitTrack *p_track);
 
-	void call_synced(const Callable &p_callable);
+	void set_tracks_param(TrackParam p_param, const PackedInt32Array &p_track_ids, const PackedFloat32Array &p_values);
+
+	void call_synced(const Callable &p_callable, const Callable &p_completed = Callable());
+	void schedule(double p_time, const Callable &p_callable);
+	void schedule_param(double p_time, int32_t p_track_id, TrackParam p_param, float p_value);
+	void clear_scheduled();
+	double get_time();
 
-	_ALWAYS_INLINE_ static void lock() { mutex.lock(); }
-	_ALWAYS_INLINE_ static void unlock() { mutex.unlock(); }
-	_ALWAYS_INLINE_ static MutexLock<RecursiveMutex> mutex_lock() { return BlipKit::MutexLock(mutex); }
+	PackedVector2Array render(double p_duration);
+	double get_render_frames_per_second();
 
 protected:
 	static void _bind_methods();
@@ -63,28 +103,159 @@ class AudioStreamBlipKitPlayback : public AudioStreamPlaybackResampled {
 	friend class AudioStreamBlipKit;
 	friend class BlipKitTrack;
 
+public:
+	enum Statistic {
+		STAT_MIX_COUNT,
+		STAT_MIX_TIME_MIN,
+		STAT_MIX_TIME_AVG,
+		STAT_MIX_TIME_MAX,
+		STAT_MIX_TIME_P99,
+		STAT_LOCK_WAIT_AVG,
+		STAT_LOCK_WAIT_MAX,
+		STAT_FRAMES_GENERATED,
+		STAT_FRAMES_ZERO_FILLED,
+		STAT_SYNC_CALLS,
+		STAT_TRACKS_ACTIVE,
+		STAT_TRACKS_PARKED,
+		STAT_MAX,
+	};
+
+	// Locks all playbacks to modify resources which may be shared between streams.
+	// A thread already holding a playback lock (e.g., in a divider callback) does
+	// not wait for other playbacks, as this could deadlock with a thread doing the
+	// same with the playbacks swapped. The lock fails instead if they stay locked.
+	class ResourceLock {
+	private:
+		static constexpr int HELD_LOCK_ATTEMPTS = 64;
+
+		bool locked = false;
+
+	public:
+		ResourceLock();
+		~ResourceLock();
+
+		_ALWAYS_INLINE_ bool is_locked() const { return locked; }
+	};
+
 private:
-	static constexpr int SAMPLE_RATE = BK_DEFAULT_SAMPLE_RATE;
 	static constexpr int CHANNEL_COUNT = 2;
-	static constexpr int CHANNEL_SIZE = 1024;
+	static constexpr int COMMAND_QUEUE_SIZE = 1024;
+	static constexpr int RENDER_CHUNK_SIZE = 1024;
+	// Track IDs contain the slot index in the lower bits and its generation in the upper bits.
+	static constexpr int TRACK_SLOT_BITS = 16;
+	static constexpr uint32_t TRACK_SLOT_MASK = (1 << TRACK_SLOT_BITS) - 1;
+	static constexpr uint32_t TRACK_GENERATION_MASK = 0x7fff; // Keeps IDs positive.
+
+	struct TrackSlot {
+		BlipKitTrack *track = nullptr;
+		uint32_t generation = 0; // Incremented when the track is detached.
+	};
+
+	struct ScheduledEvent {
+		uint64_t frame = 0;
+		uint64_t order = 0; // Keeps events at the same frame in insertion order.
+		Callable callable;
+		// Set instead of `callable` to set a track parameter without calling a script.
+		int32_t track_id = -1;
+		AudioStreamBlipKit::TrackParam param = AudioStreamBlipKit::TRACK_PARAM_MAX;
+		float value = 0.0;
+
+		// Orders the heap by the earliest event.
+		_ALWAYS_INLINE_ static bool is_later(const ScheduledEvent &p_a, const ScheduledEvent &p_b) {
+			return p_a.frame != p_b.frame ? p_a.frame > p_b.frame : p_a.order > p_b.order;
+		}
+	};
+
+	// Changes made by a callback of `call_synced` in `SYNC_MODE_DEFERRED`.
+	struct SyncRecording {
+		LocalVector<TrackCommand> commands;
+		LocalVector<Callable> completed_callables;
+	};
+
+	static inline thread_local AudioStreamBlipKitPlayback *mixing_playback = nullptr;
+	static inline thread_local AudioStreamBlipKitPlayback *recording_playback = nullptr;
+	static inline thread_local SyncRecording *recording = nullptr;
+
+	static RecursiveMutex resource_mutex;
+	static LocalVector<AudioStreamBlipKitPlayback *> playbacks;
+
+	CountedRecursiveMutex mutex;
+	std::atomic<uint32_t> lock_waiters = 0; // Threads blocked on `mutex`.
 
 	BKContext context;
-	LocalVector<BKFrame> buffer;
-	LocalVector<BlipKitTrack *> tracks;
+	CommandQueue<TrackCommand, COMMAND_QUEUE_SIZE> commands;
+	LocalVector<BlipKitTrack *> tracks; // Indexed by `BlipKitTrack::track_index`.
+	LocalVector<TrackSlot> track_slots; // Indexed by the slot index of track IDs.
+	LocalVector<uint32_t> free_track_slots;
+	std::atomic<uint32_t> active_track_count = 0;
+	std::atomic<uint32_t> parked_track_count = 0; // Attached but detached from the context while silent.
+	LocalVector<BlipKitTrack *> parking_tracks; // Parked after generating their muted output.
 	LocalVector<Callable> sync_callables;
+	LocalVector<Callable> sync_completed_callables; // Dispatched after the next sync point.
+	LocalVector<Callable> completed_callables;
+	LocalVector<ScheduledEvent> scheduled_events; // Min-heap.
+	uint64_t schedule_order = 0;
+	std::atomic<uint64_t> frame_position = 0; // Only written by the mixer.
+	AudioStreamBlipKit::SyncMode sync_mode = AudioStreamBlipKit::SYNC_MODE_AUDIO;
+	bool is_dispatch_pending = false;
 	int clock_rate = BK_DEFAULT_CLOCK_RATE;
+	int sample_rate = BK_DEFAULT_SAMPLE_RATE;
 	bool active = false;
+	bool is_silent = false; // The last generated frames were silent without active tracks.
+	LocalVector<BKDivider *> dividers; // Attached to `context`.
+	LocalVector<BKDivider *> detaching_dividers; // Detached after generating frames.
+	LocalVector<BKDivider *> attaching_dividers; // Attached after generating frames.
+	bool is_generating = false; // The context clock is ticking.
 	bool is_calling_callbacks = false;
+	bool is_rendering = false;
+	double render_frames_per_second = 0.0;
+
+	MixStatistics statistics;
+	String monitor_category;
 
 protected:
-	bool initialize(int p_clock_rate);
+	bool initialize(int p_clock_rate, int p_sample_rate, AudioStreamBlipKit::SyncMode p_sync_mode);
 	int get_clock_rate() const;
 	void set_clock_rate(int p_clock_rate);
+	int get_sample_rate() const;
+	void set_sample_rate(int p_sample_rate);
+	void set_sync_mode(AudioStreamBlipKit::SyncMode p_sync_mode);
+
+	void call_synced(const Callable &p_callable, const Callable &p_completed);
+	void call_sync_callables();
+	void dispatch_synced();
+	bool record_command(const TrackCommand &p_command);
+	// Queues the changes recorded so far, so that changes applied directly keep their order.
+	void commit_recorded_commands();
 
-	void call_synced(const Callable &p_callable);
+	void schedule(double p_time, const Callable &p_callable);
+	void schedule_param(double p_time, int32_t p_track_id, AudioStreamBlipKit::TrackParam p_param, float p_value);
+	void push_scheduled_event(ScheduledEvent &p_event, double p_time);
+	void clear_scheduled();
+	double get_time() const;
+	void call_scheduled_events();
 
 	void attach(BlipKitTrack *p_track);
 	void detach(BlipKitTrack *p_track);
+	void set_track_parked(bool p_parked);
+	// Parks the track after generating frames, so that its output is not cut off.
+	void park_track_deferred(BlipKitTrack *p_track);
+	void cancel_park_track(BlipKitTrack *p_track);
+
+	// Returns the attached track with the ID, or `nullptr` if it is not attached anymore.
+	BlipKitTrack *get_track(int32_t p_track_id) const;
+	void set_track_param(BlipKitTrack *p_track, AudioStreamBlipKit::TrackParam p_param, float p_value);
+	void set_tracks_param(AudioStreamBlipKit::TrackParam p_param, const PackedInt32Array &p_track_ids, const PackedFloat32Array &p_values);
+
+	bool push_command(const TrackCommand &p_command);
+	// Queues all commands so that they are applied by the same mix call.
+	bool push_commands(const TrackCommand *p_commands, uint32_t p_count);
+	void flush_commands();
+
+	int32_t generate_frames(AudioFrame *p_buffer, int32_t p_frames);
+	int32_t mix_frames(AudioFrame *p_buffer, int32_t p_frames);
+
+	PackedVector2Array render(double p_duration);
 
 public:
 	AudioStreamBlipKitPlayback();
@@ -92,6 +263,40 @@ public:
 
 	_ALWAYS_INLINE_ BKContext *get_context() { return &context; }
 
+	// Attaches a divider to the beat clock. Dividers are kept to detect when the
+	// context can be skipped, and to attach them again when the context changes.
+	// Dividers attached while the clock is ticking are attached after generating frames.
+	void attach_divider(BKDivider *p_divider);
+	void detach_divider(BKDivider *p_divider);
+	// Detaches a divider after generating frames, as dividers cannot be
+	// detached while the clock is ticking. Used by divider callbacks.
+	void detach_divider_deferred(BKDivider *p_divider);
+
+	_ALWAYS_INLINE_ void lock() {
+		if (mutex.try_lock()) [[likely]] {
+			return;
+		}
+
+		// Lets `render` yield the lock between chunks.
+		lock_waiters.fetch_add(1);
+		mutex.lock();
+		lock_waiters.fetch_sub(1);
+	}
+	_ALWAYS_INLINE_ void unlock() { mutex.unlock(); }
+	_ALWAYS_INLINE_ MutexLock<CountedRecursiveMutex> mutex_lock() { return BlipKit::MutexLock(mutex); }
+
+	// Removes the playback from the playbacks locked by `ResourceLock`. Used for
+	// streams which are only rendered offline, e.g. by `BlipKitBatchRenderer`.
+	// Their resources must not be modified while rendering.
+	void set_offline();
+
+	double get_statistic(Statistic p_statistic) const;
+	Dictionary get_statistics() const;
+	void reset_statistics();
+
+	void add_performance_monitors(const String &p_category = "BlipKit");
+	void remove_performance_monitors();
+
 	void _start(double p_from_pos) override;
 	void _stop() override;
 	bool _is_playing() const override;
@@ -104,3 +309,7 @@ protected:
 };
 
 } // namespace BlipKit
+
+VARIANT_ENUM_CAST(BlipKit::AudioStreamBlipKit::SyncMode);
+VARIANT_ENUM_CAST(BlipKit::AudioStreamBlipKit::TrackParam);
+VARIANT_ENUM_CAST(BlipKit::AudioStreamBlipKitPlayback::Statistic);
@@ -25,6 +25,45 @@ void BlipKitAssembler::write_header() {
 	code_section_offset = byte_code.get_position();
 }
 
+void BlipKitAssembler::optimize_code() {
+	const uint32_t code_size = byte_code.size() - code_section_offset;
+	LocalVector<uint32_t> public_labels;
+	BytecodeOptimizer optimizer;
+
+	optimizer.set_code(byte_code.ptr() + code_section_offset, code_size);
+
+	// Public labels are entry points and have to be preserved.
+	for (uint32_t i = 0; i < labels.size(); i++) {
+		if (labels[i].is_public) {
+			optimizer.add_entry(labels[i].byte_offset);
+			public_labels.push_back(i);
+		}
+	}
+
+	// Keep the code unchanged if it cannot be analyzed.
+	if (not optimizer.optimize(BytecodeOptimizer::Level(optimization_level))) {
+		return;
+	}
+
+	const LocalVector<uint8_t> &code = optimizer.get_code();
+
+	byte_code.seek(code_section_offset);
+	byte_code.put_bytes(code.ptr(), code.size());
+	byte_code.truncate(byte_code.get_position());
+
+	for (uint32_t i = 0; i < public_labels.size(); i++) {
+		labels[public_labels[i]].byte_offset = optimizer.get_entry(i);
+	}
+
+	// Update size of code segment.
+	const uint32_t byte_position = byte_code.get_position();
+	byte_code.seek(offsetof(BlipKitBytecode::Header, bytecode_size));
+	byte_code.put_u32(byte_position - sizeof(BlipKitBytecode::Header));
+	byte_code.seek(byte_position);
+
+	optimization_stats = optimizer.get_stats();
+}
+
 void BlipKitAssembler::write_sections() {
 	write_labels();
 }
@@ -437,6 +476,10 @@ BlipKitAssembler::Error BlipKitAssembler::compile() {
 	// Restore byte position.
 	byte_code.seek(byte_position);
 
+	if (optimization_level != OPTIMIZATION_LEVEL_NONE) {
+		optimize_code();
+	}
+
 	write_sections();
 
 	state = STATE_COMPILED;
@@ -444,6 +487,29 @@ BlipKitAssembler::Error BlipKitAssembler::compile() {
 	return OK;
 }
 
+void BlipKitAssembler::set_optimization_level(OptimizationLevel p_level) {
+	ERR_FAIL_INDEX(p_level, OPTIMIZATION_LEVEL_FULL + 1);
+	optimization_level = p_level;
+}
+
+BlipKitAssembler::OptimizationLevel BlipKitAssembler::get_optimization_level() const {
+	return optimization_level;
+}
+
+Dictionary BlipKitAssembler::get_optimization_stats() const {
+	Dictionary ret;
+
+	ret["size_before"] = optimization_stats.size_before;
+	ret["size_after"] = optimization_stats.size_after;
+	ret["ticks_merged"] = optimization_stats.ticks_merged;
+	ret["jumps_removed"] = optimization_stats.jumps_removed;
+	ret["unreachable_removed"] = optimization_stats.unreachable_removed;
+	ret["overwritten_removed"] = optimization_stats.overwritten_removed;
+	ret["calls_inlined"] = optimization_stats.calls_inlined;
+
+	return ret;
+}
+
 Vector<uint8_t> BlipKitAssembler::get_bytes() const {
 	return byte_code.get_bytes();
 }
@@ -481,6 +547,7 @@ void BlipKitAssembler::clear() {
 	error_message.resize(0);
 	state = STATE_ASSEMBLE;
 	code_section_offset = 0;
+	optimization_stats = BytecodeOptimizer::Stats();
 
 	write_header();
 }
@@ -493,6 +560,11 @@ void BlipKitAssembler::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_byte_code"), &BlipKitAssembler::get_byte_code);
 	ClassDB::bind_method(D_METHOD("get_error_message"), &BlipKitAssembler::get_error_message);
 	ClassDB::bind_method(D_METHOD("clear"), &BlipKitAssembler::clear);
+	ClassDB::bind_method(D_METHOD("set_optimization_level", "level"), &BlipKitAssembler::set_optimization_level);
+	ClassDB::bind_method(D_METHOD("get_optimization_level"), &BlipKitAssembler::get_optimization_level);
+	ClassDB::bind_method(D_METHOD("get_optimization_stats"), &BlipKitAssembler::get_optimization_stats);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "optimization_level", PROPERTY_HINT_ENUM, "None,Basic,Full"), "set_optimization_level", "get_optimization_level");
 
 	BIND_ENUM_CONSTANT(OP_ATTACK);
 	BIND_ENUM_CONSTANT(OP_RELEASE);
@@ -534,6 +606,10 @@ void BlipKitAssembler::_bind_methods() {
 	BIND_ENUM_CONSTANT(ERR_DUPLICATE_LABEL);
 	BIND_ENUM_CONSTANT(ERR_UNDEFINED_LABEL);
 	BIND_ENUM_CONSTANT(ERR_INVALID_LABEL);
+
+	BIND_ENUM_CONSTANT(OPTIMIZATION_LEVEL_NONE);
+	BIND_ENUM_CONSTANT(OPTIMIZATION_LEVEL_BASIC);
+	BIND_ENUM_CONSTANT(OPTIMIZATION_LEVEL_FULL);
 }
 
 String BlipKitAssembler::_to_string() const {
@@ -2,9 +2,11 @@
 
 #include "blipkit_bytecode.hpp"
 #include "byte_stream.hpp"
+#include "bytecode_optimizer.hpp"
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/templates/hash_map.hpp>
 #include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/variant.hpp>
@@ -66,6 +68,12 @@ public:
 		ERR_INVALID_LABEL,
 	};
 
+	enum OptimizationLevel {
+		OPTIMIZATION_LEVEL_NONE = BytecodeOptimizer::LEVEL_NONE,
+		OPTIMIZATION_LEVEL_BASIC = BytecodeOptimizer::LEVEL_BASIC,
+		OPTIMIZATION_LEVEL_FULL = BytecodeOptimizer::LEVEL_FULL,
+	};
+
 private:
 	enum State {
 		STATE_ASSEMBLE,
@@ -102,8 +110,11 @@ private:
 	String error_message;
 	State state = STATE_ASSEMBLE;
 	uint32_t code_section_offset = 0;
+	OptimizationLevel optimization_level = OPTIMIZATION_LEVEL_NONE;
+	BytecodeOptimizer::Stats optimization_stats;
 
 	void write_header();
+	void optimize_code();
 	void write_sections();
 	void write_labels();
 	Error get_or_add_label(const String p_label, uint32_t &r_label_index);
@@ -118,6 +129,10 @@ private:
 public:
 	BlipKitAssembler();
 
+	void set_optimization_level(OptimizationLevel p_level);
+	OptimizationLevel get_optimization_level() const;
+	Dictionary get_optimization_stats() const;
+
 	Error put(Opcode p_opcode, const Variant &p_arg1 = nullptr, const Variant &p_arg2 = nullptr, const Variant &p_arg3 = nullptr);
 	Error put_byte_code(const Ref<BlipKitBytecode> &p_byte_code, bool p_public = false);
 	Error put_label(const String p_label, int32_t p_label_position, bool p_public);
@@ -139,3 +154,4 @@ protected:
 
 VARIANT_ENUM_CAST(BlipKit::BlipKitAssembler::Opcode);
 VARIANT_ENUM_CAST(BlipKit::BlipKitAssembler::Error);
+VARIANT_ENUM_CAST(BlipKit::BlipKitAssembler::OptimizationLevel);
@@ -0,0 +1,128 @@
+#include "blipkit_batch_renderer.hpp"
+#include "audio_stream_blipkit.hpp"
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+
+using namespace BlipKit;
+using namespace godot;
+
+void BlipKitBatchRenderer::render_job(int p_index) {
+	Job &job = jobs[p_index];
+
+	// Each job uses its own stream and context.
+	Ref<AudioStreamBlipKit> stream;
+	stream.instantiate();
+	stream->set_clock_rate(clock_rate);
+	stream->set_sample_rate(sample_rate);
+
+	Ref<AudioStreamBlipKitPlayback> playback = stream->get_playback();
+	ERR_FAIL_COND(playback.is_null());
+
+	// Keep the job out of `ResourceLock`, which would wait for all rendering jobs.
+	playback->set_offline();
+
+	job.track.instantiate();
+	job.track->attach(stream.ptr());
+	job.track->add_interpreter_divider(job.interpreter);
+
+	job.frames = stream->render(job.duration);
+
+	job.track->detach();
+	job.track.unref();
+}
+
+void BlipKitBatchRenderer::set_clock_rate(int p_clock_rate) {
+	clock_rate = p_clock_rate;
+}
+
+int BlipKitBatchRenderer::get_clock_rate() const {
+	return clock_rate;
+}
+
+void BlipKitBatchRenderer::set_sample_rate(int p_sample_rate) {
+	sample_rate = p_sample_rate;
+}
+
+int BlipKitBatchRenderer::get_sample_rate() const {
+	return sample_rate;
+}
+
+int BlipKitBatchRenderer::add_job(const Ref<BlipKitInterpreter> &p_interpreter, double p_duration) {
+	ERR_FAIL_COND_V(p_interpreter.is_null(), -1);
+	ERR_FAIL_COND_V(p_duration < 0.0, -1);
+
+	for (const Job &job : jobs) {
+		ERR_FAIL_COND_V_MSG(job.interpreter == p_interpreter, -1, "Interpreter is already used by another job.");
+	}
+
+	Job job;
+	job.interpreter = p_interpreter;
+	job.duration = p_duration;
+	jobs.push_back(job);
+
+	return jobs.size() - 1;
+}
+
+int BlipKitBatchRenderer::get_job_count() const {
+	return jobs.size();
+}
+
+void BlipKitBatchRenderer::clear() {
+	jobs.clear();
+}
+
+Array BlipKitBatchRenderer::render() {
+	Array ret;
+	const uint32_t job_count = jobs.size();
+
+	if (job_count == 0) {
+		return ret;
+	}
+
+	const uint64_t start_ticks = Time::get_singleton()->get_ticks_usec();
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	const int64_t group_id = pool->add_group_task(callable_mp(this, &BlipKitBatchRenderer::render_job), job_count, -1, true, "BlipKitBatchRenderer");
+	pool->wait_for_group_task_completion(group_id);
+
+	const uint64_t elapsed_usec = MAX(Time::get_singleton()->get_ticks_usec() - start_ticks, uint64_t(1));
+	int64_t frame_count = 0;
+
+	ret.resize(job_count);
+
+	for (uint32_t i = 0; i < job_count; i++) {
+		Job &job = jobs[i];
+		frame_count += job.frames.size();
+		ret[i] = job.frames;
+		job.frames = PackedVector2Array();
+	}
+
+	frames_per_second = double(frame_count) * 1e6 / double(elapsed_usec);
+
+	return ret;
+}
+
+double BlipKitBatchRenderer::get_frames_per_second() const {
+	return frames_per_second;
+}
+
+void BlipKitBatchRenderer::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_clock_rate", "clock_rate"), &BlipKitBatchRenderer::set_clock_rate);
+	ClassDB::bind_method(D_METHOD("get_clock_rate"), &BlipKitBatchRenderer::get_clock_rate);
+	ClassDB::bind_method(D_METHOD("set_sample_rate", "sample_rate"), &BlipKitBatchRenderer::set_sample_rate);
+	ClassDB::bind_method(D_METHOD("get_sample_rate"), &BlipKitBatchRenderer::get_sample_rate);
+
+	ClassDB::bind_method(D_METHOD("add_job", "interpreter", "duration"), &BlipKitBatchRenderer::add_job);
+	ClassDB::bind_method(D_METHOD("get_job_count"), &BlipKitBatchRenderer::get_job_count);
+	ClassDB::bind_method(D_METHOD("clear"), &BlipKitBatchRenderer::clear);
+	ClassDB::bind_method(D_METHOD("render"), &BlipKitBatchRenderer::render);
+	ClassDB::bind_method(D_METHOD("get_frames_per_second"), &BlipKitBatchRenderer::get_frames_per_second);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "clock_rate"), "set_clock_rate", "get_clock_rate");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "sample_rate", PROPERTY_HINT_NONE, "suffix:Hz"), "set_sample_rate", "get_sample_rate");
+}
+
+String BlipKitBatchRenderer::_to_string() const {
+	return vformat("<BlipKitBatchRenderer#%d>", get_instance_id());
+}
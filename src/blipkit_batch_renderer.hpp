@@ -0,0 +1,51 @@
+#pragma once
+
+#include "blipkit_interpreter.hpp"
+#include "blipkit_track.hpp"
+#include <BlipKit.h>
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+
+using namespace godot;
+
+namespace BlipKit {
+
+class BlipKitBatchRenderer : public RefCounted {
+	GDCLASS(BlipKitBatchRenderer, RefCounted)
+
+private:
+	struct Job {
+		Ref<BlipKitInterpreter> interpreter;
+		Ref<BlipKitTrack> track;
+		double duration = 0.0;
+		PackedVector2Array frames;
+	};
+
+	LocalVector<Job> jobs;
+	int clock_rate = BK_DEFAULT_CLOCK_RATE;
+	int sample_rate = BK_DEFAULT_SAMPLE_RATE;
+	double frames_per_second = 0.0;
+
+	void render_job(int p_index);
+
+public:
+	void set_clock_rate(int p_clock_rate);
+	int get_clock_rate() const;
+	void set_sample_rate(int p_sample_rate);
+	int get_sample_rate() const;
+
+	int add_job(const Ref<BlipKitInterpreter> &p_interpreter, double p_duration);
+	int get_job_count() const;
+	void clear();
+
+	Array render();
+	double get_frames_per_second() const;
+
+protected:
+	static void _bind_methods();
+	String _to_string() const;
+};
+
+} // namespace BlipKit
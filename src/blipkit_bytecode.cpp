@@ -3,6 +3,7 @@
 #include "blipkit_interpreter.hpp"
 #include "blipkit_sample.hpp"
 #include "blipkit_waveform.hpp"
+#include "bytecode_program.hpp"
 #include "string_names.hpp"
 #include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/classes/resource_uid.hpp>
@@ -135,6 +136,8 @@ bool BlipKitBytecode::is_valid() const {
 
 void BlipKitBytecode::set_bytes(const Vector<uint8_t> &p_bytes) {
 	byte_code.set_bytes(p_bytes);
+	// Interpreters still using the previous program keep their reference.
+	program.reset();
 
 	if (not read_header()) {
 		return;
@@ -143,6 +146,10 @@ void BlipKitBytecode::set_bytes(const Vector<uint8_t> &p_bytes) {
 	if (not read_sections()) {
 		return;
 	}
+
+	std::shared_ptr<BytecodeProgram> decoded_program = std::make_shared<BytecodeProgram>();
+	decoded_program->decode(byte_code, get_code_section_offset(), get_code_section_size());
+	program = decoded_program;
 }
 
 BlipKitBytecode::State BlipKitBytecode::get_state() const {
@@ -168,6 +175,10 @@ PackedByteArray BlipKitBytecode::get_byte_array() const {
 	return bytes;
 }
 
+std::shared_ptr<const BytecodeProgram> BlipKitBytecode::get_program() const {
+	return program;
+}
+
 int BlipKitBytecode::get_code_section_offset() const {
 	return sizeof(Header);
 }
@@ -10,11 +10,14 @@
 #include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/variant/packed_string_array.hpp>
 #include <godot_cpp/variant/string.hpp>
+#include <memory>
 
 using namespace godot;
 
 namespace BlipKit {
 
+class BytecodeProgram;
+
 class BlipKitBytecode : public Resource {
 	GDCLASS(BlipKitBytecode, Resource)
 
@@ -47,6 +50,7 @@ private:
 	ByteStreamReader byte_code;
 	HashMap<String, uint32_t> label_indices;
 	LocalVector<Label> labels;
+	std::shared_ptr<const BytecodeProgram> program;
 	State state = OK;
 	String error_message;
 
@@ -66,6 +70,9 @@ public:
 	Vector<uint8_t> get_bytes() const;
 	PackedByteArray get_byte_array() const;
 
+	// Decoded code section shared by all interpreters using this byte code.
+	std::shared_ptr<const BytecodeProgram> get_program() const;
+
 	int get_code_section_offset() const;
 	int get_code_section_size() const;
 	bool has_label(const String &p_name) const;
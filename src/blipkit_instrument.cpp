@@ -16,7 +16,7 @@ BlipKitInstrument::BlipKitInstrument() {
 }
 
 BlipKitInstrument::~BlipKitInstrument() {
-	BK_THREAD_SAFE_METHOD
+	AudioStreamBlipKitPlayback::ResourceLock resource_lock;
 
 	BKDispose(&instrument);
 }
@@ -104,7 +104,8 @@ void BlipKitInstrument::set_envelope(EnvelopeType p_type, const PackedFloat32Arr
 		}
 	}
 
-	BK_THREAD_SAFE_METHOD
+	BK_RESOURCE_SAFE_METHOD
+	MutexLock binding_lock(binding_mutex);
 
 	BKInt result = 0;
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "mutex.hpp"
 #include <BlipKit.h>
 #include <godot_cpp/classes/resource.hpp>
 #include <godot_cpp/variant/packed_float32_array.hpp>
@@ -31,6 +32,7 @@ private:
 	};
 
 	BKInstrument instrument;
+	RecursiveMutex binding_mutex; // Guards the tracks linked to `instrument`.
 	Sequence sequences[ENVELOPE_MAX];
 
 public:
@@ -40,6 +42,8 @@ public:
 	static Ref<BlipKitInstrument> create_with_adsr(int p_attack, int p_decay, float p_sustain, int p_release);
 
 	_ALWAYS_INLINE_ BKInstrument *get_instrument() { return &instrument; };
+	// Has to be locked while linking or unlinking a track.
+	_ALWAYS_INLINE_ RecursiveMutex *get_binding_mutex() { return &binding_mutex; };
 
 	void set_envelope(EnvelopeType p_type, const PackedFloat32Array &p_values, const PackedInt32Array &p_steps = PackedInt32Array(), int p_sustain_offset = -1, int p_sustain_length = 0);
 	void set_adsr(int p_attack, int p_decay, float p_sustain, int p_release);
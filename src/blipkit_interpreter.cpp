@@ -11,16 +11,24 @@ using namespace BlipKit;
 using namespace godot;
 
 typedef BlipKitAssembler::Opcode Opcode;
-
-BlipKitInterpreter::BlipKitInterpreter() {
-	stack.reserve(STACK_SIZE_MAX);
-	arpeggio.resize(BlipKitTrack::ARPEGGIO_MAX);
-	instruments.resize(SLOT_COUNT);
-	waveforms.resize(SLOT_COUNT);
-	samples.resize(SLOT_COUNT);
-}
-
-uint32_t BlipKitInterpreter::exec_delay_begin(uint32_t p_ticks, uint32_t p_code_offset) {
+typedef BytecodeProgram::Instruction Instruction;
+
+// Dispatch with computed goto if supported.
+#if defined(__GNUC__) || defined(__clang__)
+#define BK_COMPUTED_GOTO
+#endif
+
+#ifdef BK_COMPUTED_GOTO
+#define BK_OP(m_opcode) handler_##m_opcode:
+#define BK_PSEUDO_OP(m_opcode) handler_##m_opcode:
+#define BK_DISPATCH() goto *handlers[instructions[pc].opcode]
+#else
+#define BK_OP(m_opcode) case Opcode::m_opcode:
+#define BK_PSEUDO_OP(m_opcode) case BytecodeProgram::m_opcode:
+#define BK_DISPATCH() continue
+#endif
+
+uint32_t BlipKitInterpreter::exec_delay_begin(uint32_t p_ticks, uint32_t p_pc) {
 	if (delay_register.state == DELAY_STATE_EXEC) {
 		return exec_delay_shift();
 	} else {
@@ -29,10 +37,10 @@ uint32_t BlipKitInterpreter::exec_delay_begin(uint32_t p_ticks, uint32_t p_code_
 			return 0;
 		}
 
-		// Save code offset of delay sequence.
+		// Save instruction index of delay sequence.
 		if (not delay_register.delay_size) {
 			delay_register.state = DELAY_STATE_DELAY;
-			delay_register.code_offset = p_code_offset;
+			delay_register.pc = p_pc;
 		}
 		delay_register.ticks += p_ticks;
 		delay_register.delays[delay_register.delay_size++] = p_ticks;
@@ -69,8 +77,7 @@ uint32_t BlipKitInterpreter::exec_delay_step(uint32_t p_ticks) {
 		delay_register.delays[delay_register.delay_size++] = p_ticks;
 
 		// Jump to beginning of delay sequences.
-		const uint32_t code_offset = delay_register.code_offset;
-		byte_code.seek(code_offset);
+		pc = delay_register.pc;
 
 		return 0;
 	}
@@ -95,40 +102,103 @@ int BlipKitInterpreter::fail_with_error(State p_state, const String &p_error_mes
 	error_message = p_error_message;
 
 	// Seek to end.
-	const uint32_t size = byte_code.size();
-	byte_code.seek(size);
+	const uint32_t count = program ? program->get_instruction_count() : 0;
+	pc = count ? count - 1 : 0;
 
 	ERR_FAIL_V_MSG(-1, error_message);
 }
 
+BlipKitSlotBank *BlipKitInterpreter::get_writable_slot_bank(Ref<BlipKitSlotBank> &r_previous) {
+	if (slot_bank.is_null()) {
+		slot_bank.instantiate();
+		is_slot_bank_shared = false;
+	} else if (is_slot_bank_shared) {
+		// Copy on write.
+		r_previous = slot_bank;
+		slot_bank = slot_bank->copy();
+		is_slot_bank_shared = false;
+	}
+
+	return slot_bank.ptr();
+}
+
+void BlipKitInterpreter::set_slot_bank(const Ref<BlipKitSlotBank> &p_slot_bank) {
+	// Released after unlocking, as freeing resources may lock the playbacks.
+	Ref<BlipKitSlotBank> previous;
+	MutexLock slot_bank_lock(slot_bank_mutex);
+
+	previous = slot_bank;
+	slot_bank = p_slot_bank;
+	is_slot_bank_shared = true;
+}
+
+Ref<BlipKitSlotBank> BlipKitInterpreter::get_slot_bank() const {
+	MutexLock slot_bank_lock(slot_bank_mutex);
+
+	// The caller may share the bank with other interpreters.
+	is_slot_bank_shared = true;
+
+	return slot_bank;
+}
+
 void BlipKitInterpreter::set_instrument(int p_slot, const Ref<BlipKitInstrument> &p_instrument) {
-	ERR_FAIL_INDEX(p_slot, instruments.size());
-	instruments[p_slot] = p_instrument;
+	ERR_FAIL_INDEX(p_slot, SLOT_COUNT);
+
+	Ref<BlipKitSlotBank> previous_bank;
+	Ref<BlipKitInstrument> previous;
+	MutexLock slot_bank_lock(slot_bank_mutex);
+
+	BlipKitSlotBank *bank = get_writable_slot_bank(previous_bank);
+	previous = bank->get_instrument(p_slot);
+	bank->set_instrument(p_slot, p_instrument);
 }
 
 Ref<BlipKitInstrument> BlipKitInterpreter::get_instrument(int p_slot) const {
-	ERR_FAIL_INDEX_V(p_slot, instruments.size(), nullptr);
-	return instruments[p_slot];
+	ERR_FAIL_INDEX_V(p_slot, SLOT_COUNT, nullptr);
+
+	MutexLock slot_bank_lock(slot_bank_mutex);
+
+	return slot_bank.is_valid() ? slot_bank->get_instrument(p_slot) : nullptr;
 }
 
 void BlipKitInterpreter::set_waveform(int p_slot, const Ref<BlipKitWaveform> &p_waveform) {
-	ERR_FAIL_INDEX(p_slot, waveforms.size());
-	waveforms[p_slot] = p_waveform;
+	ERR_FAIL_INDEX(p_slot, SLOT_COUNT);
+
+	Ref<BlipKitSlotBank> previous_bank;
+	Ref<BlipKitWaveform> previous;
+	MutexLock slot_bank_lock(slot_bank_mutex);
+
+	BlipKitSlotBank *bank = get_writable_slot_bank(previous_bank);
+	previous = bank->get_waveform(p_slot);
+	bank->set_waveform(p_slot, p_waveform);
 }
 
 Ref<BlipKitWaveform> BlipKitInterpreter::get_waveform(int p_slot) const {
-	ERR_FAIL_INDEX_V(p_slot, waveforms.size(), nullptr);
-	return waveforms[p_slot];
+	ERR_FAIL_INDEX_V(p_slot, SLOT_COUNT, nullptr);
+
+	MutexLock slot_bank_lock(slot_bank_mutex);
+
+	return slot_bank.is_valid() ? slot_bank->get_waveform(p_slot) : nullptr;
 }
 
 void BlipKitInterpreter::set_sample(int p_slot, const Ref<BlipKitSample> &p_sample) {
-	ERR_FAIL_INDEX(p_slot, samples.size());
-	samples[p_slot] = p_sample;
+	ERR_FAIL_INDEX(p_slot, SLOT_COUNT);
+
+	Ref<BlipKitSlotBank> previous_bank;
+	Ref<BlipKitSample> previous;
+	MutexLock slot_bank_lock(slot_bank_mutex);
+
+	BlipKitSlotBank *bank = get_writable_slot_bank(previous_bank);
+	previous = bank->get_sample(p_slot);
+	bank->set_sample(p_slot, p_sample);
 }
 
 Ref<BlipKitSample> BlipKitInterpreter::get_sample(int p_slot) const {
-	ERR_FAIL_INDEX_V(p_slot, samples.size(), nullptr);
-	return samples[p_slot];
+	ERR_FAIL_INDEX_V(p_slot, SLOT_COUNT, nullptr);
+
+	MutexLock slot_bank_lock(slot_bank_mutex);
+
+	return slot_bank.is_valid() ? slot_bank->get_sample(p_slot) : nullptr;
 }
 
 void BlipKitInterpreter::set_step_ticks(int p_step_ticks) {
@@ -155,7 +225,7 @@ bool BlipKitInterpreter::load_byte_code(const Ref<BlipKitBytecode> &p_byte_code,
 	}
 
 	byte_code_res = p_byte_code;
-	byte_code.set_bytes(byte_code_res->get_bytes());
+	program = p_byte_code->get_program();
 
 	reset(p_start_label);
 
@@ -165,294 +235,425 @@ bool BlipKitInterpreter::load_byte_code(const Ref<BlipKitBytecode> &p_byte_code,
 int BlipKitInterpreter::advance(const Ref<BlipKitTrack> &p_track) {
 	ERR_FAIL_COND_V(p_track.is_null(), 0);
 
-	while (byte_code.get_available_bytes() > 0) {
-		const uint32_t code_offset = byte_code.get_position();
-		const Opcode opcode = static_cast<Opcode>(byte_code.get_u8());
-		const bool execute = delay_register.state != DELAY_STATE_DELAY;
+	return advance_track(p_track.ptr());
+}
 
-		switch (opcode) {
-			case Opcode::OP_NOOP: {
-				// Do nothing.
-			} break;
-			case Opcode::OP_HALT: {
-				state = OK_FINISHED;
-				return 0;
-			} break;
-			case Opcode::OP_ATTACK: {
-				const float value = byte_code.get_f16();
+int BlipKitInterpreter::advance_track(BlipKitTrack *p_track) {
+	// No byte code loaded.
+	if (not program || pc >= program->get_instruction_count()) [[unlikely]] {
+		return finish();
+	}
 
-				if (execute) [[likely]] {
-					p_track->set_note(value);
-				}
-			} break;
-			case Opcode::OP_RELEASE: {
-				if (execute) [[likely]] {
-					p_track->release();
-				}
-			} break;
-			case Opcode::OP_MUTE: {
-				if (execute) [[likely]] {
-					p_track->mute();
-				}
-			} break;
-			case Opcode::OP_VOLUME: {
-				const float value = byte_code.get_f16();
+	const Instruction *instructions = program->get_instructions();
+	const float *values = program->get_values();
+
+#ifdef BK_COMPUTED_GOTO
+	// Same order as `Opcode`, followed by the pseudo opcodes.
+	static const void *handlers[] = {
+		&&handler_OP_NOOP,
+		&&handler_OP_HALT,
+		&&handler_OP_ATTACK,
+		&&handler_OP_RELEASE,
+		&&handler_OP_MUTE,
+		&&handler_OP_VOLUME,
+		&&handler_OP_MASTER_VOLUME,
+		&&handler_OP_PANNING,
+		&&handler_OP_WAVEFORM,
+		&&handler_OP_DUTY_CYCLE,
+		&&handler_OP_PITCH,
+		&&handler_OP_PHASE_WRAP,
+		&&handler_OP_PORTAMENTO,
+		&&handler_OP_VIBRATO,
+		&&handler_OP_TREMOLO,
+		&&handler_OP_VOLUME_SLIDE,
+		&&handler_OP_PANNING_SLIDE,
+		&&handler_OP_EFFECT_DIV,
+		&&handler_OP_ARPEGGIO,
+		&&handler_OP_ARPEGGIO_DIV,
+		&&handler_OP_TICK,
+		&&handler_OP_STEP,
+		&&handler_OP_STEP_TICKS,
+		&&handler_OP_DELAY_TICK,
+		&&handler_OP_DELAY_STEP,
+		&&handler_OP_JUMP,
+		&&handler_OP_CALL,
+		&&handler_OP_RETURN,
+		&&handler_OP_RESET,
+		&&handler_OP_INSTRUMENT,
+		&&handler_OP_INSTRUMENT_DIV,
+		&&handler_OP_CUSTOM_WAVEFORM,
+		&&handler_OP_SAMPLE,
+		&&handler_OP_SAMPLE_PITCH,
+		&&handler_OP_END,
+		&&handler_OP_FAIL,
+	};
+	static_assert(sizeof(handlers) / sizeof(handlers[0]) == BytecodeProgram::OP_COUNT, "Handlers do not match opcodes.");
+
+	BK_DISPATCH();
+#else
+	for (;;) {
+		switch (instructions[pc].opcode) {
+#endif
+
+	BK_OP(OP_NOOP) {
+		// Do nothing.
+		pc++;
+		BK_DISPATCH();
+	}
+	BK_OP(OP_HALT) {
+		pc++;
+		state = OK_FINISHED;
+		return 0;
+	}
+	BK_OP(OP_ATTACK) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (execute) [[likely]] {
-					p_track->set_volume(value);
-				}
-			} break;
-			case Opcode::OP_MASTER_VOLUME: {
-				const float value = byte_code.get_f16();
+		if (is_executing()) [[likely]] {
+			p_track->set_note(instruction.args[0]);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_RELEASE) {
+		pc++;
 
-				if (execute) [[likely]] {
-					p_track->set_master_volume(value);
-				}
-			} break;
-			case Opcode::OP_PANNING: {
-				const float value = byte_code.get_f16();
+		if (is_executing()) [[likely]] {
+			p_track->release();
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_MUTE) {
+		pc++;
 
-				if (execute) [[likely]] {
-					p_track->set_panning(value);
-				}
-			} break;
-			case Opcode::OP_WAVEFORM: {
-				const int32_t value = byte_code.get_u8();
+		if (is_executing()) [[likely]] {
+			p_track->mute();
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_VOLUME) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (execute) [[likely]] {
-					p_track->set_waveform(static_cast<BlipKitTrack::Waveform>(value));
-				}
-			} break;
-			case Opcode::OP_DUTY_CYCLE: {
-				const int32_t value = byte_code.get_u8();
+		if (is_executing()) [[likely]] {
+			p_track->set_volume(instruction.args[0]);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_MASTER_VOLUME) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (execute) [[likely]] {
-					p_track->set_duty_cycle(value);
-				}
-			} break;
-			case Opcode::OP_PITCH: {
-				const float value = byte_code.get_f16();
+		if (is_executing()) [[likely]] {
+			p_track->set_master_volume(instruction.args[0]);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_PANNING) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (execute) [[likely]] {
-					p_track->set_pitch(value);
-				}
-			} break;
-			case Opcode::OP_PHASE_WRAP: {
-				const int32_t value = byte_code.get_u8();
+		if (is_executing()) [[likely]] {
+			p_track->set_panning(instruction.args[0]);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_WAVEFORM) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (execute) [[likely]] {
-					p_track->set_phase_wrap(value);
-				}
-			} break;
-			case Opcode::OP_PORTAMENTO: {
-				const float steps = byte_code.get_f16();
+		if (is_executing()) [[likely]] {
+			p_track->set_waveform(static_cast<BlipKitTrack::Waveform>(instruction.arg_u8));
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_DUTY_CYCLE) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (execute) [[likely]] {
-					const uint32_t ticks = steps * step_ticks;
-					p_track->set_portamento(ticks);
-				}
-			} break;
-			case Opcode::OP_VIBRATO: {
-				const float steps = byte_code.get_f16();
-				const float delta = byte_code.get_f16();
-				const float slide_steps = byte_code.get_f16();
-
-				if (execute) [[likely]] {
-					const uint32_t ticks = steps * step_ticks;
-					const uint32_t slide_ticks = slide_steps * step_ticks;
-					p_track->set_vibrato(ticks, delta, slide_ticks);
-				}
-			} break;
-			case Opcode::OP_TREMOLO: {
-				const float steps = byte_code.get_f16();
-				const float delta = byte_code.get_f16();
-				const float slide_steps = byte_code.get_f16();
-
-				if (execute) [[likely]] {
-					const uint32_t ticks = steps * step_ticks;
-					const uint32_t slide_ticks = slide_steps * step_ticks;
-					p_track->set_tremolo(ticks, delta, slide_ticks);
-				}
-			} break;
-			case Opcode::OP_VOLUME_SLIDE: {
-				const float steps = byte_code.get_f16();
+		if (is_executing()) [[likely]] {
+			p_track->set_duty_cycle(instruction.arg_u8);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_PITCH) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (execute) [[likely]] {
-					const uint32_t ticks = steps * step_ticks;
-					p_track->set_volume_slide(ticks);
-				}
-			} break;
-			case Opcode::OP_PANNING_SLIDE: {
-				const float steps = byte_code.get_f16();
+		if (is_executing()) [[likely]] {
+			p_track->set_pitch(instruction.args[0]);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_PHASE_WRAP) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (execute) [[likely]] {
-					const uint32_t ticks = steps * step_ticks;
-					p_track->set_panning_slide(ticks);
-				}
-			} break;
-			case Opcode::OP_EFFECT_DIV: {
-				const uint32_t value = byte_code.get_u16();
+		if (is_executing()) [[likely]] {
+			p_track->set_phase_wrap(instruction.arg_u8);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_PORTAMENTO) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (execute) [[likely]] {
-					p_track->set_effect_divider(value);
-				}
-			} break;
-			case Opcode::OP_ARPEGGIO: {
-				const int32_t count = byte_code.get_u8();
-
-				if (execute) [[likely]] {
-					arpeggio.resize(count);
-					for (uint32_t i = 0; i < count; i++) {
-						arpeggio[i] = byte_code.get_f16();
-					}
-					p_track->set_arpeggio(arpeggio);
-				} else {
-					const uint32_t position = byte_code.get_position();
-					byte_code.seek(position + count * 2);
-				}
-			} break;
-			case Opcode::OP_ARPEGGIO_DIV: {
-				const int32_t value = byte_code.get_u16();
+		if (is_executing()) [[likely]] {
+			const uint32_t ticks = instruction.args[0] * step_ticks;
+			p_track->set_portamento(ticks);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_VIBRATO) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (execute) [[likely]] {
-					p_track->set_arpeggio_divider(value);
-				}
-			} break;
-			case Opcode::OP_TICK: {
-				int32_t ticks = byte_code.get_u16();
+		if (is_executing()) [[likely]] {
+			const uint32_t ticks = instruction.args[0] * step_ticks;
+			const uint32_t slide_ticks = instruction.args[2] * step_ticks;
+			p_track->set_vibrato(ticks, instruction.args[1], slide_ticks);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_TREMOLO) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (delay_register.delay_size) {
-					ticks = exec_delay_step(ticks);
-				}
+		if (is_executing()) [[likely]] {
+			const uint32_t ticks = instruction.args[0] * step_ticks;
+			const uint32_t slide_ticks = instruction.args[2] * step_ticks;
+			p_track->set_tremolo(ticks, instruction.args[1], slide_ticks);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_VOLUME_SLIDE) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (ticks) [[likely]] {
-					return ticks;
-				}
-			} break;
-			case Opcode::OP_STEP: {
-				const int32_t steps = byte_code.get_u16();
-				int32_t ticks = steps * step_ticks;
+		if (is_executing()) [[likely]] {
+			const uint32_t ticks = instruction.args[0] * step_ticks;
+			p_track->set_volume_slide(ticks);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_PANNING_SLIDE) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (delay_register.delay_size) {
-					ticks = exec_delay_step(ticks);
-				}
+		if (is_executing()) [[likely]] {
+			const uint32_t ticks = instruction.args[0] * step_ticks;
+			p_track->set_panning_slide(ticks);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_EFFECT_DIV) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (ticks) [[likely]] {
-					return ticks;
-				}
-			} break;
-			case Opcode::OP_STEP_TICKS: {
-				const uint32_t step_ticks = byte_code.get_u16();
+		if (is_executing()) [[likely]] {
+			p_track->set_effect_divider(instruction.arg_u16);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_ARPEGGIO) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (execute) [[likely]] {
-					set_step_ticks(step_ticks);
-				}
-			} break;
-			case Opcode::OP_DELAY_TICK: {
-				uint32_t ticks = byte_code.get_u16();
+		if (is_executing()) [[likely]] {
+			p_track->set_arpeggio_values(&values[instruction.index], instruction.arg_u8);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_ARPEGGIO_DIV) {
+		const Instruction &instruction = instructions[pc++];
 
-				ticks = exec_delay_begin(ticks, code_offset);
+		if (is_executing()) [[likely]] {
+			p_track->set_arpeggio_divider(instruction.arg_u16);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_TICK) {
+		const Instruction &instruction = instructions[pc++];
+		int32_t ticks = instruction.arg_u16;
 
-				if (ticks) [[likely]] {
-					return ticks;
-				}
-			} break;
-			case Opcode::OP_DELAY_STEP: {
-				const float delay = byte_code.get_f16();
-				uint32_t ticks = delay * step_ticks;
+		if (delay_register.delay_size) {
+			ticks = exec_delay_step(ticks);
+		}
 
-				ticks = exec_delay_begin(ticks, code_offset);
+		if (ticks) [[likely]] {
+			return ticks;
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_STEP) {
+		const Instruction &instruction = instructions[pc++];
+		int32_t ticks = instruction.arg_u16 * step_ticks;
 
-				if (ticks) [[likely]] {
-					return ticks;
-				}
-			} break;
-			case Opcode::OP_JUMP: {
-				const int32_t offset = byte_code.get_s32();
+		if (delay_register.delay_size) {
+			ticks = exec_delay_step(ticks);
+		}
 
-				if (execute) [[likely]] {
-					const int32_t position = byte_code.get_position();
-					const int32_t jump_offset = position + offset - sizeof(int32_t); // Subtract size of address.
-					byte_code.seek(jump_offset);
-				}
-			} break;
-			case Opcode::OP_CALL: {
-				const int32_t offset = byte_code.get_s32();
-
-				if (execute) [[likely]] {
-					if (stack.size() >= STACK_SIZE_MAX) [[unlikely]] {
-						return fail_with_error(ERR_STACK_OVERFLOW, "Stack overflow.");
-					}
-
-					const int32_t position = byte_code.get_position();
-					const int32_t jump_offset = position + offset - sizeof(int32_t); // Subtract size of address.
-					stack.push_back(position);
-					byte_code.seek(jump_offset);
-				}
-			} break;
-			case Opcode::OP_RETURN: {
-				if (execute) [[likely]] {
-					if (stack.is_empty()) {
-						return fail_with_error(ERR_STACK_OVERFLOW, "Stack underflow.");
-					}
-
-					// Pop last value.
-					const uint32_t index = stack.size() - 1;
-					const uint32_t offset = stack[index];
-
-					stack.resize(index);
-					byte_code.seek(offset);
-				}
-			} break;
-			case Opcode::OP_RESET: {
-				if (execute) [[likely]] {
-					p_track->reset();
-				}
-			} break;
-			case Opcode::OP_INSTRUMENT: {
-				const int32_t index = byte_code.get_u8();
+		if (ticks) [[likely]] {
+			return ticks;
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_STEP_TICKS) {
+		const Instruction &instruction = instructions[pc++];
 
-				if (execute) [[likely]] {
-					const Ref<BlipKitInstrument> &instrument = instruments[index];
-					p_track->set_instrument(instrument);
-				}
-			} break;
-			case Opcode::OP_INSTRUMENT_DIV: {
-				const int32_t value = byte_code.get_u16();
+		if (is_executing()) [[likely]] {
+			set_step_ticks(instruction.arg_u16);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_DELAY_TICK) {
+		const Instruction &instruction = instructions[pc++];
+		const uint32_t ticks = exec_delay_begin(instruction.arg_u16, pc - 1);
 
-				if (execute) [[likely]] {
-					p_track->set_instrument_divider(value);
-				}
-			} break;
-			case Opcode::OP_CUSTOM_WAVEFORM: {
-				const int32_t index = byte_code.get_u8();
+		if (ticks) [[likely]] {
+			return ticks;
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_DELAY_STEP) {
+		const Instruction &instruction = instructions[pc++];
+		uint32_t ticks = instruction.args[0] * step_ticks;
 
-				if (execute) [[likely]] {
-					const Ref<BlipKitWaveform> &waveform = waveforms[index];
-					p_track->set_custom_waveform(waveform);
+		ticks = exec_delay_begin(ticks, pc - 1);
+
+		if (ticks) [[likely]] {
+			return ticks;
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_JUMP) {
+		const Instruction &instruction = instructions[pc++];
+
+		if (is_executing()) [[likely]] {
+			if (instruction.index == BytecodeProgram::INVALID_INDEX) [[unlikely]] {
+				return fail_with_error(ERR_INVALID_BINARY, vformat("Invalid jump target at offset %d.", instruction.code_offset));
+			}
+
+			pc = instruction.index;
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_CALL) {
+		const Instruction &instruction = instructions[pc++];
+
+		if (is_executing()) [[likely]] {
+			if (stack_size >= STACK_SIZE_MAX) [[unlikely]] {
+				return fail_with_error(ERR_STACK_OVERFLOW, "Stack overflow.");
+			}
+
+			if (instruction.index == BytecodeProgram::INVALID_INDEX) [[unlikely]] {
+				return fail_with_error(ERR_INVALID_BINARY, vformat("Invalid jump target at offset %d.", instruction.code_offset));
+			}
+
+			stack[stack_size++] = pc;
+			pc = instruction.index;
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_RETURN) {
+		pc++;
+
+		if (is_executing()) [[likely]] {
+			if (not stack_size) {
+				return fail_with_error(ERR_STACK_OVERFLOW, "Stack underflow.");
+			}
+
+			// Pop last value.
+			pc = stack[--stack_size];
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_RESET) {
+		pc++;
+
+		if (is_executing()) [[likely]] {
+			p_track->reset();
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_INSTRUMENT) {
+		const Instruction &instruction = instructions[pc++];
+
+		if (is_executing()) [[likely]] {
+			Ref<BlipKitInstrument> instrument;
+
+			{
+				MutexLock slot_bank_lock(slot_bank_mutex);
+
+				if (slot_bank.is_valid()) [[likely]] {
+					instrument = slot_bank->get_slot_instrument(instruction.arg_u8);
 				}
-			} break;
-			case Opcode::OP_SAMPLE: {
-				const int32_t index = byte_code.get_u8();
+			}
+
+			p_track->set_instrument(instrument);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_INSTRUMENT_DIV) {
+		const Instruction &instruction = instructions[pc++];
+
+		if (is_executing()) [[likely]] {
+			p_track->set_instrument_divider(instruction.arg_u16);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_CUSTOM_WAVEFORM) {
+		const Instruction &instruction = instructions[pc++];
+
+		if (is_executing()) [[likely]] {
+			Ref<BlipKitWaveform> waveform;
 
-				if (execute) [[likely]] {
-					const Ref<BlipKitSample> &sample = samples[index];
-					p_track->set_sample(sample);
+			{
+				MutexLock slot_bank_lock(slot_bank_mutex);
+
+				if (slot_bank.is_valid()) [[likely]] {
+					waveform = slot_bank->get_slot_waveform(instruction.arg_u8);
 				}
-			} break;
-			case Opcode::OP_SAMPLE_PITCH: {
-				const float pitch = byte_code.get_f16();
+			}
+
+			p_track->set_custom_waveform(waveform);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_SAMPLE) {
+		const Instruction &instruction = instructions[pc++];
+
+		if (is_executing()) [[likely]] {
+			Ref<BlipKitSample> sample;
 
-				if (execute) [[likely]] {
-					p_track->set_sample_pitch(pitch);
+			{
+				MutexLock slot_bank_lock(slot_bank_mutex);
+
+				if (slot_bank.is_valid()) [[likely]] {
+					sample = slot_bank->get_slot_sample(instruction.arg_u8);
 				}
-			} break;
+			}
+
+			p_track->set_sample(sample);
+		}
+		BK_DISPATCH();
+	}
+	BK_OP(OP_SAMPLE_PITCH) {
+		const Instruction &instruction = instructions[pc++];
+
+		if (is_executing()) [[likely]] {
+			p_track->set_sample_pitch(instruction.args[0]);
+		}
+		BK_DISPATCH();
+	}
+	BK_PSEUDO_OP(OP_END) {
+		// Stay at the end.
+		return finish();
+	}
+	BK_PSEUDO_OP(OP_FAIL) {
+		const Instruction &instruction = instructions[pc];
+
+		if (instruction.arg_u8 == BytecodeProgram::FAIL_TRUNCATED) {
+			return fail_with_error(ERR_INVALID_BINARY, vformat("Truncated instruction at offset %d.", instruction.code_offset));
+		}
+
+		return fail_with_error(ERR_INVALID_OPCODE, vformat("Invalid opcode %d at offset %d.", instruction.arg_u16, instruction.code_offset));
+	}
+
+#ifndef BK_COMPUTED_GOTO
 			default: {
-				return fail_with_error(ERR_INVALID_OPCODE, vformat("Invalid opcode %d at offset %d.", opcode, code_offset));
+				return fail_with_error(ERR_INVALID_OPCODE, vformat("Invalid opcode %d.", instructions[pc].opcode));
 			} break;
 		}
 	}
+#endif
+}
 
+int BlipKitInterpreter::finish() {
 	// At this point there are no more instrutions.
 	if (state == OK_RUNNING) {
 		state = OK_FINISHED;
@@ -484,23 +685,29 @@ void BlipKitInterpreter::reset(const String &p_start_label) {
 		}
 	}
 
-	uint32_t start_position = byte_code_res->get_code_section_offset();
+	uint32_t start_pc = 0;
 
 	if (not p_start_label.is_empty()) {
 		const int32_t label_index = byte_code_res->find_label(p_start_label);
-		start_position += byte_code_res->get_label_position(label_index);
+		start_pc = program->find_instruction(byte_code_res->get_label_position(label_index));
+
+		if (start_pc == BytecodeProgram::INVALID_INDEX) {
+			fail_with_error(ERR_INVALID_LABEL, vformat("Label '%s' has an invalid position.", p_start_label));
+			return;
+		}
 	}
 
-	byte_code.seek(start_position);
+	pc = start_pc;
 
-	stack.clear();
+	stack_size = 0;
 	delay_register = DelayRegister();
-	arpeggio.clear();
 	state = OK_RUNNING;
 	error_message.resize(0);
 }
 
 void BlipKitInterpreter::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_slot_bank", "slot_bank"), &BlipKitInterpreter::set_slot_bank);
+	ClassDB::bind_method(D_METHOD("get_slot_bank"), &BlipKitInterpreter::get_slot_bank);
 	ClassDB::bind_method(D_METHOD("set_instrument", "slot", "instrument"), &BlipKitInterpreter::set_instrument);
 	ClassDB::bind_method(D_METHOD("get_instrument", "slot"), &BlipKitInterpreter::get_instrument);
 	ClassDB::bind_method(D_METHOD("set_waveform", "slot", "waveform"), &BlipKitInterpreter::set_waveform);
@@ -515,6 +722,7 @@ void BlipKitInterpreter::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_error_message"), &BlipKitInterpreter::get_error_message);
 	ClassDB::bind_method(D_METHOD("reset", "start_label"), &BlipKitInterpreter::reset, DEFVAL(""));
 
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "slot_bank"), "set_slot_bank", "get_slot_bank");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "step_ticks"), "set_step_ticks", "get_step_ticks");
 
 	BIND_ENUM_CONSTANT(OK_RUNNING);
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "blipkit_bytecode.hpp"
-#include "byte_stream.hpp"
+#include "blipkit_slot_bank.hpp"
+#include "bytecode_program.hpp"
+#include "mutex.hpp"
 #include <BlipKit.h>
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/templates/local_vector.hpp>
@@ -21,7 +23,7 @@ class BlipKitInterpreter : public RefCounted {
 
 public:
 	static constexpr int STACK_SIZE_MAX = 16;
-	static constexpr int SLOT_COUNT = 256;
+	static constexpr int SLOT_COUNT = BlipKitSlotBank::SLOT_COUNT;
 	static constexpr int STEP_TICKS_DEFAULT = 24;
 
 	enum State {
@@ -44,7 +46,7 @@ private:
 	struct DelayRegister {
 		static constexpr int MAX_DELAYS = 8;
 
-		uint32_t code_offset = 0;
+		uint32_t pc = 0; // Start of delay sequence.
 		uint32_t ticks = 0;
 		DelayState state = DELAY_STATE_NONE;
 		uint8_t delay_index = 0;
@@ -52,29 +54,39 @@ private:
 		uint32_t delays[MAX_DELAYS] = { 0 };
 	};
 
-	ByteStreamReader byte_code;
+	std::shared_ptr<const BytecodeProgram> program;
+	uint32_t pc = 0;
 	Ref<BlipKitBytecode> byte_code_res;
 
-	LocalVector<uint32_t> stack;
+	uint32_t stack[STACK_SIZE_MAX] = { 0 };
+	uint32_t stack_size = 0;
 	DelayRegister delay_register;
-	PackedFloat32Array arpeggio;
 	uint32_t step_ticks = STEP_TICKS_DEFAULT;
 
-	LocalVector<Ref<BlipKitInstrument>> instruments;
-	LocalVector<Ref<BlipKitWaveform>> waveforms;
-	LocalVector<Ref<BlipKitSample>> samples;
+	// Copied before setting a slot if it may be shared with other interpreters.
+	Ref<BlipKitSlotBank> slot_bank;
+	mutable RecursiveMutex slot_bank_mutex; // Guards `slot_bank` while the audio thread reads slots.
+	mutable bool is_slot_bank_shared = false; // Set when assigned or returned by `get_slot_bank`.
 
 	State state = OK_RUNNING;
 	String error_message;
 
-	uint32_t exec_delay_begin(uint32_t p_ticks, uint32_t p_code_offset);
+	uint32_t exec_delay_begin(uint32_t p_ticks, uint32_t p_pc);
 	uint32_t exec_delay_step(uint32_t p_ticks);
 	uint32_t exec_delay_shift();
 
 	int fail_with_error(State p_status, const String &p_error_message);
+	int finish();
+
+	// Has to be called with `slot_bank_mutex` locked. A replaced bank is moved
+	// to `r_previous`, so that it is not freed while locked.
+	BlipKitSlotBank *get_writable_slot_bank(Ref<BlipKitSlotBank> &r_previous);
+
+	_ALWAYS_INLINE_ bool is_executing() const { return delay_register.state != DELAY_STATE_DELAY; }
 
 public:
-	BlipKitInterpreter();
+	void set_slot_bank(const Ref<BlipKitSlotBank> &p_slot_bank);
+	Ref<BlipKitSlotBank> get_slot_bank() const;
 
 	void set_instrument(int p_slot, const Ref<BlipKitInstrument> &p_instrument);
 	Ref<BlipKitInstrument> get_instrument(int p_slot) const;
@@ -89,6 +101,8 @@ public:
 	bool load_byte_code(const Ref<BlipKitBytecode> &p_byte_code, const String &p_start_label = "");
 
 	int advance(const Ref<BlipKitTrack> &p_track);
+	// Same as `advance` but called directly by dividers on the audio thread.
+	int advance_track(BlipKitTrack *p_track);
 	State get_state() const;
 	String get_error_message() const;
 
@@ -13,7 +13,7 @@ BlipKitSample::BlipKitSample() {
 }
 
 BlipKitSample::~BlipKitSample() {
-	BK_THREAD_SAFE_METHOD
+	AudioStreamBlipKitPlayback::ResourceLock resource_lock;
 
 	BKDispose(&data);
 }
@@ -133,7 +133,8 @@ void BlipKitSample::set_frames(const PackedFloat32Array &p_frames, bool p_normal
 		}
 	}
 
-	BK_THREAD_SAFE_METHOD
+	BK_RESOURCE_SAFE_METHOD
+	MutexLock binding_lock(binding_mutex);
 
 	frames.resize(frames_size);
 
@@ -212,7 +213,8 @@ void BlipKitSample::set_frame_bytes(const PackedByteArray &p_frames) {
 	// TODO: Check for endianess.
 	const BKFrame *ptr = reinterpret_cast<const BKFrame *>(p_frames.ptr());
 
-	BK_THREAD_SAFE_METHOD
+	BK_RESOURCE_SAFE_METHOD
+	MutexLock binding_lock(binding_mutex);
 
 	frames.resize(frame_count);
 	BKFrame *ptrw = frames.ptr();
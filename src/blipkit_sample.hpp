@@ -1,5 +1,6 @@
 #pragma once
 
+#include "mutex.hpp"
 #include <BlipKit.h>
 #include <godot_cpp/classes/audio_stream_wav.hpp>
 #include <godot_cpp/classes/ref.hpp>
@@ -25,6 +26,7 @@ public:
 
 private:
 	BKData data;
+	RecursiveMutex binding_mutex; // Guards the tracks linked to `data`.
 	LocalVector<BKFrame> frames;
 	uint32_t sustain_offset = 0;
 	uint32_t sustain_end = 0;
@@ -37,6 +39,8 @@ public:
 	static Ref<BlipKitSample> create_with_wav(const Ref<AudioStreamWAV> &p_wav, bool p_normalize = false, float p_amplitude = 1.0);
 
 	_ALWAYS_INLINE_ BKData *get_data() { return &data; };
+	// Has to be locked while linking or unlinking a track.
+	_ALWAYS_INLINE_ RecursiveMutex *get_binding_mutex() { return &binding_mutex; };
 	_ALWAYS_INLINE_ int size() const { return frames.size(); };
 	_ALWAYS_INLINE_ bool is_valid() const { return !frames.is_empty(); };
 
@@ -0,0 +1,169 @@
+#include "blipkit_sequencer.hpp"
+#include "audio_stream_blipkit.hpp"
+
+using namespace BlipKit;
+using namespace godot;
+
+#define BK_SEQUENCER_SAFE_METHOD Lock _sequencer_lock_(this);
+
+BlipKitSequencer::Lock::Lock(const BlipKitSequencer *p_sequencer) :
+		playback(p_sequencer->playback.ptr()) {
+	// Entries are not accessed by the audio thread if not attached.
+	if (playback) {
+		playback->lock();
+	}
+}
+
+BlipKitSequencer::Lock::~Lock() {
+	if (playback) {
+		playback->unlock();
+	}
+}
+
+BlipKitSequencer::BlipKitSequencer() {
+	BKCallback callback = {
+		.func = divider_callback,
+		.userInfo = static_cast<void *>(this),
+	};
+	BKDividerInit(&divider, 1, &callback);
+}
+
+BlipKitSequencer::~BlipKitSequencer() {
+	detach();
+}
+
+BKEnum BlipKitSequencer::divider_callback(BKCallbackInfo *p_info, void *p_user_info) {
+	BlipKitSequencer *sequencer = static_cast<BlipKitSequencer *>(p_user_info);
+	sequencer->advance();
+
+	return BK_SUCCESS;
+}
+
+void BlipKitSequencer::advance() {
+	const uint64_t *ticks = next_ticks.ptr();
+	const uint32_t count = next_ticks.size();
+
+	tick++;
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (ticks[i] > tick) [[likely]] {
+			continue;
+		}
+
+		BlipKitInterpreter *interpreter = interpreters[i].ptr();
+
+		// Wait until the interpreter is reset, or the track is attached to this stream again.
+		if (interpreter->get_state() != BlipKitInterpreter::OK_RUNNING || tracks[i]->get_playback() != playback.ptr()) {
+			next_ticks[i] = tick + 1;
+			continue;
+		}
+
+		const int advance_ticks = interpreter->advance_track(tracks[i].ptr());
+		next_ticks[i] = tick + MAX(advance_ticks, 1);
+	}
+}
+
+int BlipKitSequencer::find_entry(int p_id) const {
+	for (uint32_t i = 0; i < ids.size(); i++) {
+		if (ids[i] == p_id) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+void BlipKitSequencer::remove_entry(uint32_t p_index) {
+	// Swap with the last entry to keep the arrays dense.
+	next_ticks.remove_at_unordered(p_index);
+	interpreters.remove_at_unordered(p_index);
+	tracks.remove_at_unordered(p_index);
+	ids.remove_at_unordered(p_index);
+}
+
+void BlipKitSequencer::attach(AudioStreamBlipKit *p_stream) {
+	ERR_FAIL_NULL(p_stream);
+
+	detach();
+
+	Ref<AudioStreamBlipKitPlayback> stream_playback = p_stream->get_playback();
+	ERR_FAIL_COND(stream_playback.is_null());
+
+	MutexLock playback_lock = stream_playback->mutex_lock();
+
+	playback = stream_playback;
+	playback->attach_divider(&divider);
+}
+
+void BlipKitSequencer::detach() {
+	if (playback.is_null()) {
+		return;
+	}
+
+	MutexLock playback_lock = playback->mutex_lock();
+
+	playback->detach_divider(&divider);
+	playback.unref();
+}
+
+int BlipKitSequencer::add(const Ref<BlipKitInterpreter> &p_interpreter, const Ref<BlipKitTrack> &p_track) {
+	BK_SEQUENCER_SAFE_METHOD
+
+	ERR_FAIL_COND_V(p_interpreter.is_null(), 0);
+	ERR_FAIL_COND_V(p_track.is_null(), 0);
+	ERR_FAIL_COND_V_MSG(p_track->get_playback() != playback.ptr(), 0, "Track must be attached to the same stream as the sequencer.");
+
+	const int id = next_id++;
+
+	// Advance on the next tick.
+	next_ticks.push_back(tick + 1);
+	interpreters.push_back(p_interpreter);
+	tracks.push_back(p_track);
+	ids.push_back(id);
+
+	return id;
+}
+
+bool BlipKitSequencer::has(int p_id) const {
+	BK_SEQUENCER_SAFE_METHOD
+
+	return find_entry(p_id) >= 0;
+}
+
+void BlipKitSequencer::remove(int p_id) {
+	BK_SEQUENCER_SAFE_METHOD
+
+	const int index = find_entry(p_id);
+	ERR_FAIL_COND(index < 0);
+
+	remove_entry(index);
+}
+
+void BlipKitSequencer::clear() {
+	BK_SEQUENCER_SAFE_METHOD
+
+	next_ticks.clear();
+	interpreters.clear();
+	tracks.clear();
+	ids.clear();
+}
+
+int BlipKitSequencer::get_count() const {
+	BK_SEQUENCER_SAFE_METHOD
+
+	return ids.size();
+}
+
+void BlipKitSequencer::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("attach", "playback"), &BlipKitSequencer::attach);
+	ClassDB::bind_method(D_METHOD("detach"), &BlipKitSequencer::detach);
+	ClassDB::bind_method(D_METHOD("add", "interpreter", "track"), &BlipKitSequencer::add);
+	ClassDB::bind_method(D_METHOD("has", "id"), &BlipKitSequencer::has);
+	ClassDB::bind_method(D_METHOD("remove", "id"), &BlipKitSequencer::remove);
+	ClassDB::bind_method(D_METHOD("clear"), &BlipKitSequencer::clear);
+	ClassDB::bind_method(D_METHOD("get_count"), &BlipKitSequencer::get_count);
+}
+
+String BlipKitSequencer::_to_string() const {
+	return vformat("<BlipKitSequencer#%d>", get_instance_id());
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "blipkit_interpreter.hpp"
+#include "blipkit_track.hpp"
+#include <BlipKit.h>
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+
+using namespace godot;
+
+namespace BlipKit {
+
+class AudioStreamBlipKit;
+class AudioStreamBlipKitPlayback;
+
+// Advances many interpreters from a single divider.
+class BlipKitSequencer : public RefCounted {
+	GDCLASS(BlipKitSequencer, RefCounted)
+
+private:
+	// Locks the attached playback.
+	class Lock {
+	private:
+		AudioStreamBlipKitPlayback *playback = nullptr;
+
+	public:
+		Lock(const BlipKitSequencer *p_sequencer);
+		~Lock();
+	};
+
+	// Entries are stored as parallel arrays, so that checking which entries
+	// are due only reads `next_ticks`.
+	LocalVector<uint64_t> next_ticks;
+	LocalVector<Ref<BlipKitInterpreter>> interpreters;
+	LocalVector<Ref<BlipKitTrack>> tracks;
+	LocalVector<int> ids;
+
+	BKDivider divider = { { 0 } };
+	Ref<AudioStreamBlipKitPlayback> playback;
+	uint64_t tick = 0;
+	int next_id = 1;
+
+	static BKEnum divider_callback(BKCallbackInfo *p_info, void *p_user_info);
+
+	void advance();
+	int find_entry(int p_id) const;
+	void remove_entry(uint32_t p_index);
+
+public:
+	BlipKitSequencer();
+	~BlipKitSequencer();
+
+	void attach(AudioStreamBlipKit *p_stream);
+	void detach();
+
+	int add(const Ref<BlipKitInterpreter> &p_interpreter, const Ref<BlipKitTrack> &p_track);
+	bool has(int p_id) const;
+	void remove(int p_id);
+	void clear();
+	int get_count() const;
+
+protected:
+	static void _bind_methods();
+	String _to_string() const;
+};
+
+} // namespace BlipKit
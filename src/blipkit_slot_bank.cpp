@@ -0,0 +1,75 @@
+#include "blipkit_slot_bank.hpp"
+#include "blipkit_instrument.hpp"
+#include "blipkit_sample.hpp"
+#include "blipkit_waveform.hpp"
+
+using namespace BlipKit;
+using namespace godot;
+
+static_assert(BlipKitSlotBank::SLOT_COUNT == UINT8_MAX + 1, "Slots have to be addressable with `uint8_t`.");
+
+BlipKitSlotBank::BlipKitSlotBank() {
+	// Slots are never resized, so the audio thread can read them without bounds checks.
+	instruments.resize(SLOT_COUNT);
+	waveforms.resize(SLOT_COUNT);
+	samples.resize(SLOT_COUNT);
+}
+
+Ref<BlipKitSlotBank> BlipKitSlotBank::copy() const {
+	Ref<BlipKitSlotBank> bank;
+	bank.instantiate();
+
+	for (int i = 0; i < SLOT_COUNT; i++) {
+		bank->instruments[i] = instruments[i];
+		bank->waveforms[i] = waveforms[i];
+		bank->samples[i] = samples[i];
+	}
+
+	return bank;
+}
+
+void BlipKitSlotBank::set_instrument(int p_slot, const Ref<BlipKitInstrument> &p_instrument) {
+	ERR_FAIL_INDEX(p_slot, SLOT_COUNT);
+	instruments[p_slot] = p_instrument;
+}
+
+Ref<BlipKitInstrument> BlipKitSlotBank::get_instrument(int p_slot) const {
+	ERR_FAIL_INDEX_V(p_slot, SLOT_COUNT, nullptr);
+	return instruments[p_slot];
+}
+
+void BlipKitSlotBank::set_waveform(int p_slot, const Ref<BlipKitWaveform> &p_waveform) {
+	ERR_FAIL_INDEX(p_slot, SLOT_COUNT);
+	waveforms[p_slot] = p_waveform;
+}
+
+Ref<BlipKitWaveform> BlipKitSlotBank::get_waveform(int p_slot) const {
+	ERR_FAIL_INDEX_V(p_slot, SLOT_COUNT, nullptr);
+	return waveforms[p_slot];
+}
+
+void BlipKitSlotBank::set_sample(int p_slot, const Ref<BlipKitSample> &p_sample) {
+	ERR_FAIL_INDEX(p_slot, SLOT_COUNT);
+	samples[p_slot] = p_sample;
+}
+
+Ref<BlipKitSample> BlipKitSlotBank::get_sample(int p_slot) const {
+	ERR_FAIL_INDEX_V(p_slot, SLOT_COUNT, nullptr);
+	return samples[p_slot];
+}
+
+void BlipKitSlotBank::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("copy"), &BlipKitSlotBank::copy);
+	ClassDB::bind_method(D_METHOD("set_instrument", "slot", "instrument"), &BlipKitSlotBank::set_instrument);
+	ClassDB::bind_method(D_METHOD("get_instrument", "slot"), &BlipKitSlotBank::get_instrument);
+	ClassDB::bind_method(D_METHOD("set_waveform", "slot", "waveform"), &BlipKitSlotBank::set_waveform);
+	ClassDB::bind_method(D_METHOD("get_waveform", "slot"), &BlipKitSlotBank::get_waveform);
+	ClassDB::bind_method(D_METHOD("set_sample", "slot", "sample"), &BlipKitSlotBank::set_sample);
+	ClassDB::bind_method(D_METHOD("get_sample", "slot"), &BlipKitSlotBank::get_sample);
+
+	BIND_CONSTANT(SLOT_COUNT);
+}
+
+String BlipKitSlotBank::_to_string() const {
+	return vformat("<BlipKitSlotBank#%d>", get_instance_id());
+}
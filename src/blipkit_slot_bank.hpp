@@ -0,0 +1,50 @@
+#pragma once
+
+#include <godot_cpp/classes/ref.hpp>
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+
+using namespace godot;
+
+namespace BlipKit {
+
+class BlipKitInstrument;
+class BlipKitSample;
+class BlipKitWaveform;
+
+// Instrument, waveform and sample slots shared by multiple interpreters.
+class BlipKitSlotBank : public RefCounted {
+	GDCLASS(BlipKitSlotBank, RefCounted)
+
+public:
+	static constexpr int SLOT_COUNT = 256;
+
+private:
+	LocalVector<Ref<BlipKitInstrument>> instruments;
+	LocalVector<Ref<BlipKitWaveform>> waveforms;
+	LocalVector<Ref<BlipKitSample>> samples;
+
+public:
+	BlipKitSlotBank();
+
+	// Returns a copy with the same slots.
+	Ref<BlipKitSlotBank> copy() const;
+
+	void set_instrument(int p_slot, const Ref<BlipKitInstrument> &p_instrument);
+	Ref<BlipKitInstrument> get_instrument(int p_slot) const;
+	void set_waveform(int p_slot, const Ref<BlipKitWaveform> &p_waveform);
+	Ref<BlipKitWaveform> get_waveform(int p_slot) const;
+	void set_sample(int p_slot, const Ref<BlipKitSample> &p_sample);
+	Ref<BlipKitSample> get_sample(int p_slot) const;
+
+	// Used by the interpreter on the audio thread. Slots are in range of `uint8_t`.
+	_ALWAYS_INLINE_ const Ref<BlipKitInstrument> &get_slot_instrument(uint8_t p_slot) const { return instruments[p_slot]; }
+	_ALWAYS_INLINE_ const Ref<BlipKitWaveform> &get_slot_waveform(uint8_t p_slot) const { return waveforms[p_slot]; }
+	_ALWAYS_INLINE_ const Ref<BlipKitSample> &get_slot_sample(uint8_t p_slot) const { return samples[p_slot]; }
+
+protected:
+	static void _bind_methods();
+	String _to_string() const;
+};
+
+} // namespace BlipKit
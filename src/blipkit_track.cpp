@@ -7,14 +7,49 @@
 #include <godot_cpp/classes/project_settings.hpp>
 #include <godot_cpp/core/math.hpp>
 #include <godot_cpp/variant/variant.hpp>
+#include <thread>
 
 using namespace BlipKit;
 using namespace godot;
 
+#define BK_TRACK_SAFE_METHOD Lock _track_lock_(this);
+
 static constexpr float MASTER_VOLUME_DEFAULT = 0.15;
 static constexpr float MASTER_VOLUME_BASS = 0.3;
 
-BlipKitTrack::BlipKitTrack() {
+BlipKitTrack::Lock::Lock(const BlipKitTrack *p_track) {
+	while (true) {
+		playback = p_track->playback.load();
+
+		// Unattached tracks are not accessed by the audio thread.
+		if (not playback) {
+			return;
+		}
+
+		playback->lock();
+
+		// The track may have been detached or attached to another playback in
+		// the meantime.
+		if (p_track->playback.load() == playback) [[likely]] {
+			break;
+		}
+
+		playback->unlock();
+	}
+
+	// Apply queued changes before accessing the track directly.
+	playback->flush_commands();
+}
+
+BlipKitTrack::Lock::~Lock() {
+	// Unlock the same playback even if the track was detached in between.
+	if (playback) {
+		playback->unlock();
+	}
+}
+
+BlipKitTrack::BlipKitTrack() :
+		dividers(this) {
 	BKInt result = BKTrackInit(&track, BK_SQUARE);
 	ERR_FAIL_COND_MSG(result != BK_SUCCESS, vformat("Failed to initialize BKTrack: %s.", BKStatusGetName(result)));
 
@@ -23,15 +58,53 @@ BlipKitTrack::BlipKitTrack() {
 
 	// Set default waveform.
 	set_waveform(WAVEFORM_SQUARE);
+
+	BKCallback callback = {
+		.func = interpreter_callback,
+		.userInfo = static_cast<void *>(this),
+	};
+	BKDividerInit(&interpreter_divider, 1, &callback);
+}
+
+template <typename T>
+static _ALWAYS_INLINE_ RecursiveMutex *get_binding_mutex(const Ref<T> &p_resource) {
+	return p_resource.is_valid() ? p_resource->get_binding_mutex() : nullptr;
 }
 
 BlipKitTrack::~BlipKitTrack() {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	detach();
+
+	OrderedMutexLock<RecursiveMutex, 3> binding_lock({ get_binding_mutex(instrument), get_binding_mutex(custom_waveform), get_binding_mutex(sample) });
 	BKDispose(&track);
 }
 
+BKEnum BlipKitTrack::interpreter_callback(BKCallbackInfo *p_info, void *p_user_info) {
+	BlipKitTrack *track = static_cast<BlipKitTrack *>(p_user_info);
+	BlipKitInterpreter *interpreter = track->interpreter.ptr();
+
+	if (interpreter->get_state() == BlipKitInterpreter::OK_RUNNING) [[likely]] {
+		track->interpreter_counter--;
+
+		if (track->interpreter_counter > 0) [[likely]] {
+			return BK_SUCCESS;
+		}
+
+		track->interpreter_counter = interpreter->advance_track(track);
+
+		if (interpreter->get_state() == BlipKitInterpreter::OK_RUNNING) [[likely]] {
+			return BK_SUCCESS;
+		}
+	}
+
+	// Stop calling the interpreter when it has finished or failed.
+	track->mute();
+	track->get_playback()->detach_divider_deferred(&track->interpreter_divider);
+
+	return BK_SUCCESS;
+}
+
 Ref<BlipKitTrack> BlipKitTrack::create_with_waveform(BlipKitTrack::Waveform p_waveform) {
 	Ref<BlipKitTrack> instance;
 	instance.instantiate();
@@ -40,19 +113,23 @@ Ref<BlipKitTrack> BlipKitTrack::create_with_waveform(BlipKitTrack::Waveform p_wa
 	return instance;
 }
 
-void BlipKitTrack::set_master_volume(float p_master_volume) {
-	BK_THREAD_SAFE_METHOD
+int BlipKitTrack::get_track_id() const {
+	BK_TRACK_SAFE_METHOD
 
+	return track_id;
+}
+
+void BlipKitTrack::set_master_volume(float p_master_volume) {
 	p_master_volume = CLAMP(p_master_volume, 0.0, 1.0);
 	const BKInt value = BKInt(p_master_volume * float(BK_MAX_VOLUME));
 
-	BKSetAttr(&track, BK_MASTER_VOLUME, value);
+	set_attr(BK_MASTER_VOLUME, value);
 
 	master_volume_changed = true;
 }
 
 float BlipKitTrack::get_master_volume() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_MASTER_VOLUME, &value);
@@ -61,16 +138,14 @@ float BlipKitTrack::get_master_volume() const {
 }
 
 void BlipKitTrack::set_volume(float p_volume) {
-	BK_THREAD_SAFE_METHOD
-
 	p_volume = CLAMP(p_volume, 0.0, 1.0);
 	const BKInt value = BKInt(p_volume * float(BK_MAX_VOLUME));
 
-	BKSetAttr(&track, BK_VOLUME, value);
+	set_attr(BK_VOLUME, value);
 }
 
 float BlipKitTrack::get_volume() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_VOLUME, &value);
@@ -79,16 +154,14 @@ float BlipKitTrack::get_volume() const {
 }
 
 void BlipKitTrack::set_panning(float p_panning) {
-	BK_THREAD_SAFE_METHOD
-
 	p_panning = CLAMP(p_panning, -1.0, +1.0);
 	BKInt value = BKInt(p_panning * float(BK_MAX_VOLUME));
 
-	BKSetAttr(&track, BK_PANNING, value);
+	set_attr(BK_PANNING, value);
 }
 
 float BlipKitTrack::get_panning() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_PANNING, &value);
@@ -112,13 +185,22 @@ void BlipKitTrack::set_waveform(BlipKitTrack::Waveform p_waveform) {
 		} break;
 	}
 
-	mute();
+	// Applied directly after staged changes.
+	commit_update();
+
+	BK_TRACK_SAFE_METHOD
+
+	apply_attr(BK_NOTE, NOTE_MUTE);
 	update_waveform(p_waveform);
 }
 
 BlipKitTrack::Waveform BlipKitTrack::get_waveform() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
+	return read_waveform();
+}
+
+BlipKitTrack::Waveform BlipKitTrack::read_waveform() const {
 	BKInt value = 0;
 	Waveform waveform = WAVEFORM_SQUARE;
 
@@ -152,13 +234,11 @@ BlipKitTrack::Waveform BlipKitTrack::get_waveform() const {
 }
 
 void BlipKitTrack::set_duty_cycle(int p_duty_cycle) {
-	BK_THREAD_SAFE_METHOD
-
-	BKSetAttr(&track, BK_DUTY_CYCLE, p_duty_cycle);
+	set_attr(BK_DUTY_CYCLE, p_duty_cycle);
 }
 
 int BlipKitTrack::get_duty_cycle() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_DUTY_CYCLE, &value);
@@ -178,13 +258,11 @@ void BlipKitTrack::set_note(float p_note) {
 		value = NOTE_RELEASE;
 	}
 
-	BK_THREAD_SAFE_METHOD
-
-	BKSetAttr(&track, BK_NOTE, value);
+	set_attr(BK_NOTE, value);
 }
 
 float BlipKitTrack::get_note() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_NOTE, &value);
@@ -198,16 +276,14 @@ float BlipKitTrack::get_note() const {
 }
 
 void BlipKitTrack::set_pitch(float p_pitch) {
-	BK_THREAD_SAFE_METHOD
-
 	p_pitch = CLAMP(p_pitch, -float(BK_MAX_NOTE), +float(BK_MAX_NOTE));
 	BKInt value = BKInt(p_pitch * float(BK_FINT20_UNIT));
 
-	BKSetAttr(&track, BK_PITCH, value);
+	set_attr(BK_PITCH, value);
 }
 
 float BlipKitTrack::get_pitch() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_PITCH, &value);
@@ -216,19 +292,17 @@ float BlipKitTrack::get_pitch() const {
 }
 
 void BlipKitTrack::set_phase_wrap(int p_phase_wrap) {
-	BK_THREAD_SAFE_METHOD
-
 	if (p_phase_wrap > 0) {
 		p_phase_wrap = MAX(2, p_phase_wrap);
 	} else {
 		p_phase_wrap = 0;
 	}
 
-	BKSetAttr(&track, BK_PHASE_WRAP, p_phase_wrap);
+	set_attr(BK_PHASE_WRAP, p_phase_wrap);
 }
 
 int BlipKitTrack::get_phase_wrap() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_PHASE_WRAP, &value);
@@ -237,13 +311,11 @@ int BlipKitTrack::get_phase_wrap() const {
 }
 
 void BlipKitTrack::set_volume_slide(int p_volume_slide) {
-	BK_THREAD_SAFE_METHOD
-
-	BKSetAttr(&track, BK_EFFECT_VOLUME_SLIDE, p_volume_slide);
+	set_attr(BK_EFFECT_VOLUME_SLIDE, p_volume_slide);
 }
 
 int BlipKitTrack::get_volume_slide() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_EFFECT_VOLUME_SLIDE, &value);
@@ -252,13 +324,11 @@ int BlipKitTrack::get_volume_slide() const {
 }
 
 void BlipKitTrack::set_panning_slide(int p_panning_slide) {
-	BK_THREAD_SAFE_METHOD
-
-	BKSetAttr(&track, BK_EFFECT_PANNING_SLIDE, p_panning_slide);
+	set_attr(BK_EFFECT_PANNING_SLIDE, p_panning_slide);
 }
 
 int BlipKitTrack::get_panning_slide() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_EFFECT_VOLUME_SLIDE, &value);
@@ -267,13 +337,11 @@ int BlipKitTrack::get_panning_slide() const {
 }
 
 void BlipKitTrack::set_portamento(int p_portamento) {
-	BK_THREAD_SAFE_METHOD
-
-	BKSetAttr(&track, BK_EFFECT_PORTAMENTO, p_portamento);
+	set_attr(BK_EFFECT_PORTAMENTO, p_portamento);
 }
 
 int BlipKitTrack::get_portamento() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_EFFECT_PORTAMENTO, &value);
@@ -282,14 +350,12 @@ int BlipKitTrack::get_portamento() const {
 }
 
 void BlipKitTrack::set_tremolo(int p_ticks, float p_delta, int p_slide_ticks) {
-	BK_THREAD_SAFE_METHOD
-
 	p_delta = CLAMP(p_delta, 0.0, 1.0);
 	p_slide_ticks = MAX(p_slide_ticks, 0);
 	const BKInt delta = BKInt(p_delta * float(BK_MAX_VOLUME));
 	BKInt values[3] = { p_ticks, delta, p_slide_ticks };
 
-	BKSetPtr(&track, BK_EFFECT_TREMOLO, values, sizeof(values));
+	set_ptr(BK_EFFECT_TREMOLO, values, 3);
 }
 
 Dictionary BlipKitTrack::get_tremolo() const {
@@ -298,7 +364,7 @@ Dictionary BlipKitTrack::get_tremolo() const {
 	Variant &delta_value = ret[BKStringName(delta)];
 	Variant &slide_ticks_value = ret[BKStringName(slide_ticks)];
 
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt values[3] = { 0 };
 	BKGetPtr(&track, BK_EFFECT_TREMOLO, values, sizeof(values));
@@ -311,14 +377,12 @@ Dictionary BlipKitTrack::get_tremolo() const {
 }
 
 void BlipKitTrack::set_vibrato(int p_ticks, float p_delta, int p_slide_ticks) {
-	BK_THREAD_SAFE_METHOD
-
 	p_delta = CLAMP(p_delta, -float(BK_MAX_NOTE), +float(BK_MAX_NOTE));
 	p_slide_ticks = MAX(p_slide_ticks, 0);
 	const BKInt delta = BKInt(p_delta * float(BK_FINT20_UNIT));
 	BKInt values[3] = { p_ticks, delta, p_slide_ticks };
 
-	BKSetPtr(&track, BK_EFFECT_VIBRATO, values, sizeof(values));
+	set_ptr(BK_EFFECT_VIBRATO, values, 3);
 }
 
 Dictionary BlipKitTrack::get_vibrato() const {
@@ -327,7 +391,7 @@ Dictionary BlipKitTrack::get_vibrato() const {
 	Variant &delta_value = ret[BKStringName(delta)];
 	Variant &slide_ticks_value = ret[BKStringName(slide_ticks)];
 
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt values[3] = { 0 };
 	BKGetPtr(&track, BK_EFFECT_VIBRATO, values, sizeof(values));
@@ -340,14 +404,12 @@ Dictionary BlipKitTrack::get_vibrato() const {
 }
 
 void BlipKitTrack::set_effect_divider(int p_effect_divider) {
-	BK_THREAD_SAFE_METHOD
-
 	p_effect_divider = MAX(0, p_effect_divider);
-	BKSetAttr(&track, BK_EFFECT_DIVIDER, p_effect_divider);
+	set_attr(BK_EFFECT_DIVIDER, p_effect_divider);
 }
 
 int BlipKitTrack::get_effect_divider() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_EFFECT_DIVIDER, &value);
@@ -356,34 +418,42 @@ int BlipKitTrack::get_effect_divider() const {
 }
 
 void BlipKitTrack::set_arpeggio(const PackedFloat32Array &p_arpeggio) {
-	BK_THREAD_SAFE_METHOD
+	set_arpeggio_values(p_arpeggio.ptr(), p_arpeggio.size());
+}
 
-	BKInt value[BK_MAX_ARPEGGIO + 1] = { 0 };
-	const int count = MIN(p_arpeggio.size(), BK_MAX_ARPEGGIO);
-	const float *ptr = p_arpeggio.ptr();
+PackedFloat32Array BlipKitTrack::get_arpeggio() const {
+	PackedFloat32Array values;
+	values.resize(arpeggio_size);
+	float *ptrw = values.ptrw();
 
-	value[0] = count;
-	for (uint32_t i = 0; i < count; i++) {
-		value[i + 1] = BKInt(CLAMP(ptr[i], -float(BK_MAX_NOTE), +float(BK_MAX_NOTE)) * float(BK_FINT20_UNIT));
+	for (int i = 0; i < arpeggio_size; i++) {
+		ptrw[i] = arpeggio[i];
 	}
 
-	arpeggio = p_arpeggio;
-	BKSetPtr(&track, BK_ARPEGGIO, value, (count + 1) * sizeof(BKInt));
+	return values;
 }
 
-PackedFloat32Array BlipKitTrack::get_arpeggio() const {
-	return arpeggio;
+void BlipKitTrack::set_arpeggio_values(const float *p_values, int p_count) {
+	BKInt value[BK_MAX_ARPEGGIO + 1] = { 0 };
+	const int count = CLAMP(p_count, 0, ARPEGGIO_MAX);
+
+	value[0] = count;
+	for (int i = 0; i < count; i++) {
+		arpeggio[i] = p_values[i];
+		value[i + 1] = BKInt(CLAMP(p_values[i], -float(BK_MAX_NOTE), +float(BK_MAX_NOTE)) * float(BK_FINT20_UNIT));
+	}
+
+	arpeggio_size = count;
+	set_ptr(BK_ARPEGGIO, value, count + 1);
 }
 
 void BlipKitTrack::set_arpeggio_divider(int p_arpeggio_divider) {
-	BK_THREAD_SAFE_METHOD
-
 	p_arpeggio_divider = MAX(0, p_arpeggio_divider);
-	BKSetAttr(&track, BK_ARPEGGIO_DIVIDER, p_arpeggio_divider);
+	set_attr(BK_ARPEGGIO_DIVIDER, p_arpeggio_divider);
 }
 
 int BlipKitTrack::get_arpeggio_divider() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_ARPEGGIO_DIVIDER, &value);
@@ -392,7 +462,13 @@ int BlipKitTrack::get_arpeggio_divider() const {
 }
 
 void BlipKitTrack::set_instrument(const Ref<BlipKitInstrument> &p_instrument) {
-	BK_THREAD_SAFE_METHOD
+	commit_update();
+
+	BK_TRACK_SAFE_METHOD
+
+	// Keep the previous instrument until the track is unlinked from it.
+	const Ref<BlipKitInstrument> previous_instrument = instrument;
+	OrderedMutexLock<RecursiveMutex, 2> binding_lock({ get_binding_mutex(previous_instrument), get_binding_mutex(p_instrument) });
 
 	instrument = p_instrument;
 
@@ -401,6 +477,9 @@ void BlipKitTrack::set_instrument(const Ref<BlipKitInstrument> &p_instrument) {
 	} else {
 		BKSetPtr(&track, BK_INSTRUMENT, nullptr, 0);
 	}
+
+	// Released notes are only silent without an instrument.
+	update_parked();
 }
 
 Ref<BlipKitInstrument> BlipKitTrack::get_instrument() {
@@ -408,14 +487,12 @@ Ref<BlipKitInstrument> BlipKitTrack::get_instrument() {
 }
 
 void BlipKitTrack::set_instrument_divider(int p_instrument_divider) {
-	BK_THREAD_SAFE_METHOD
-
 	p_instrument_divider = MAX(0, p_instrument_divider);
-	BKSetAttr(&track, BK_INSTRUMENT_DIVIDER, p_instrument_divider);
+	set_attr(BK_INSTRUMENT_DIVIDER, p_instrument_divider);
 }
 
 int BlipKitTrack::get_instrument_divider() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_INSTRUMENT_DIVIDER, &value);
@@ -424,7 +501,9 @@ int BlipKitTrack::get_instrument_divider() const {
 }
 
 void BlipKitTrack::set_custom_waveform(const Ref<BlipKitWaveform> &p_waveform) {
-	BK_THREAD_SAFE_METHOD
+	commit_update();
+
+	BK_TRACK_SAFE_METHOD
 
 	const bool is_set = p_waveform.is_valid();
 
@@ -432,11 +511,16 @@ void BlipKitTrack::set_custom_waveform(const Ref<BlipKitWaveform> &p_waveform) {
 		ERR_FAIL_COND(not p_waveform->is_valid());
 	}
 
+	// Keep the previous resources until the track is unlinked from them.
+	const Ref<BlipKitWaveform> previous_waveform = custom_waveform;
+	const Ref<BlipKitSample> previous_sample = sample;
+	OrderedMutexLock<RecursiveMutex, 3> binding_lock({ get_binding_mutex(previous_waveform), get_binding_mutex(previous_sample), get_binding_mutex(p_waveform) });
+
 	custom_waveform = p_waveform;
 	sample.unref();
 
 	const Waveform waveform = is_set ? WAVEFORM_CUSTOM : WAVEFORM_SQUARE;
-	mute();
+	apply_attr(BK_NOTE, NOTE_MUTE);
 	update_waveform(waveform);
 }
 
@@ -445,7 +529,9 @@ Ref<BlipKitWaveform> BlipKitTrack::get_custom_waveform() {
 }
 
 void BlipKitTrack::set_sample(const Ref<BlipKitSample> &p_sample) {
-	BK_THREAD_SAFE_METHOD
+	commit_update();
+
+	BK_TRACK_SAFE_METHOD
 
 	const bool is_set = p_sample.is_valid();
 
@@ -453,11 +539,15 @@ void BlipKitTrack::set_sample(const Ref<BlipKitSample> &p_sample) {
 		ERR_FAIL_COND(not p_sample->is_valid());
 	}
 
+	const Ref<BlipKitWaveform> previous_waveform = custom_waveform;
+	const Ref<BlipKitSample> previous_sample = sample;
+	OrderedMutexLock<RecursiveMutex, 3> binding_lock({ get_binding_mutex(previous_waveform), get_binding_mutex(previous_sample), get_binding_mutex(p_sample) });
+
 	sample = p_sample;
 	custom_waveform.unref();
 
 	const Waveform waveform = is_set ? WAVEFORM_SAMPLE : WAVEFORM_SQUARE;
-	mute();
+	apply_attr(BK_NOTE, NOTE_MUTE);
 	update_waveform(waveform);
 }
 
@@ -469,13 +559,11 @@ void BlipKitTrack::set_sample_pitch(float p_pitch) {
 	p_pitch = CLAMP(p_pitch, -float(BK_MAX_NOTE), +float(BK_MAX_NOTE));
 	BKInt value = BKInt(p_pitch * float(BK_FINT20_UNIT));
 
-	BK_THREAD_SAFE_METHOD
-
-	BKSetAttr(&track, BK_SAMPLE_PITCH, value);
+	set_attr(BK_SAMPLE_PITCH, value);
 }
 
 float BlipKitTrack::get_sample_pitch() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	BKInt value = 0;
 	BKGetAttr(&track, BK_SAMPLE_PITCH, &value);
@@ -483,8 +571,29 @@ float BlipKitTrack::get_sample_pitch() const {
 	return float(value) / float(BK_FINT20_UNIT);
 }
 
+void BlipKitTrack::set_interpreter(const Ref<BlipKitInterpreter> &p_interpreter) {
+	BK_TRACK_SAFE_METHOD
+
+	AudioStreamBlipKitPlayback *current = get_playback();
+
+	if (current && interpreter.is_valid()) {
+		current->detach_divider(&interpreter_divider);
+	}
+
+	interpreter = p_interpreter;
+	interpreter_counter = 0;
+
+	if (current && interpreter.is_valid()) {
+		current->attach_divider(&interpreter_divider);
+	}
+}
+
+Ref<BlipKitInterpreter> BlipKitTrack::get_interpreter() const {
+	return interpreter;
+}
+
 void BlipKitTrack::attach(AudioStreamBlipKit *p_stream) {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	ERR_FAIL_NULL(p_stream);
 
@@ -492,40 +601,133 @@ void BlipKitTrack::attach(AudioStreamBlipKit *p_stream) {
 
 	ERR_FAIL_COND(stream_playback.is_null());
 
-	BKContext *context = stream_playback->get_context();
+	if (get_playback() == stream_playback.ptr()) {
+		return;
+	}
+
+	// Detach from the previous stream.
+	detach();
+
+	MutexLock playback_lock = stream_playback->mutex_lock();
 
-	BKTrackAttach(&track, context);
-	playback = stream_playback.ptr();
-	playback->attach(this);
+	playback.store(stream_playback.ptr());
+	stream_playback->attach(this);
+
+	attach_context();
+}
+
+void BlipKitTrack::detach() {
+	BK_TRACK_SAFE_METHOD
+
+	AudioStreamBlipKitPlayback *current = get_playback();
+
+	if (not current) {
+		return;
+	}
+
+	// Apply queued changes while still attached.
+	flush_commands();
+	// Mute directly as changes may be staged by an update.
+	apply_attr(BK_NOTE, NOTE_MUTE);
+	detach_context();
+	current->detach(this);
+
+	// Stop queuing commands and wait for other threads which are queuing
+	// commands right now. Their commands are discarded by `flush_commands`.
+	playback.store(nullptr);
+
+	while (command_pushes.load() > 0) {
+		std::this_thread::yield();
+	}
+
+	current->flush_commands();
+}
+
+void BlipKitTrack::attach_context() {
+	if (not parked) {
+		attach_track();
+	}
+
+	update_parked();
+
+	dividers.attach(get_playback());
+
+	if (interpreter.is_valid()) {
+		get_playback()->attach_divider(&interpreter_divider);
+	}
+}
+
+void BlipKitTrack::detach_context() {
+	if (interpreter.is_valid()) {
+		get_playback()->detach_divider(&interpreter_divider);
+	}
+
+	dividers.detach();
+
+	if (not parked) {
+		BKTrackDetach(&track);
+	}
+}
+
+void BlipKitTrack::attach_track() {
+	BKTrackAttach(&track, get_playback()->get_context());
 
 	if (custom_waveform.is_valid()) {
 		// Custom waveform needs to be set again after attaching.
-		set_custom_waveform(custom_waveform);
+		BKSetAttr(&track, BK_NOTE, NOTE_MUTE);
+		update_waveform(WAVEFORM_CUSTOM);
 	} else if (sample.is_valid()) {
 		// Sample needs to be set again after attaching.
-		set_sample(sample);
+		BKSetAttr(&track, BK_NOTE, NOTE_MUTE);
+		update_waveform(WAVEFORM_SAMPLE);
 	}
 
-	// TODO: Make better.
-	set_note(get_note());
-
-	dividers.attach(playback);
+	// Set note again to update the attached track.
+	BKInt note = 0;
+	BKGetAttr(&track, BK_NOTE, &note);
+	BKSetAttr(&track, BK_NOTE, note >= 0 ? note : BKInt(NOTE_RELEASE));
 }
 
-void BlipKitTrack::detach() {
-	BK_THREAD_SAFE_METHOD
+void BlipKitTrack::update_parked(BKInt p_note) {
+	AudioStreamBlipKitPlayback *current = get_playback();
 
-	if (not playback) {
+	if (not current) {
 		return;
 	}
 
-	dividers.detach();
+	// Released notes are silent immediately without an instrument.
+	const bool is_silent = p_note == NOTE_MUTE || (p_note == NOTE_RELEASE && instrument.is_null());
 
-	mute();
-	BKTrackDetach(&track);
+	if (is_silent) {
+		// Keep the track attached until the muted output has been generated.
+		// Dividers stay attached and may play a note again.
+		if (not parked && not parking) {
+			current->park_track_deferred(this);
+		}
+	} else {
+		if (parking) {
+			current->cancel_park_track(this);
+		}
+
+		if (parked) {
+			attach_track();
+			parked = false;
+			current->set_track_parked(false);
+		}
+	}
+}
+
+void BlipKitTrack::update_parked() {
+	BKInt note = 0;
+	BKGetAttr(&track, BK_NOTE, &note);
+	update_parked(note);
+}
 
-	playback->detach(this);
-	playback = nullptr;
+void BlipKitTrack::park() {
+	BKTrackDetach(&track);
+	parking = false;
+	parked = true;
+	get_playback()->set_track_parked(true);
 }
 
 void BlipKitTrack::release() {
@@ -537,29 +739,76 @@ void BlipKitTrack::mute() {
 }
 
 void BlipKitTrack::reset() {
-	BK_THREAD_SAFE_METHOD
+	commit_update();
 
-	const Waveform waveform = get_waveform();
-	const float master_volume = get_master_volume();
+	BK_TRACK_SAFE_METHOD
 
+	const Waveform waveform = read_waveform();
+	BKInt master_volume = 0;
+	BKGetAttr(&track, BK_MASTER_VOLUME, &master_volume);
+
+	const Ref<BlipKitInstrument> previous_instrument = instrument;
+	OrderedMutexLock<RecursiveMutex, 3> binding_lock({ get_binding_mutex(previous_instrument), get_binding_mutex(custom_waveform), get_binding_mutex(sample) });
 	BKTrackReset(&track);
+	attribute_cache_mask = 0;
 	instrument.unref();
-	arpeggio.clear();
+	arpeggio_size = 0;
 
 	// TODO: Reset custom waveform and sample?
 
 	update_waveform(waveform);
-	set_master_volume(master_volume);
+	apply_attr(BK_MASTER_VOLUME, master_volume);
+	master_volume_changed = true;
+
+	update_parked();
+}
+
+void BlipKitTrack::begin_update() {
+	MutexLock update_lock(update_mutex);
+
+	update_depth.fetch_add(1);
+}
+
+void BlipKitTrack::end_update() {
+	LocalVector<TrackCommand> commands;
+
+	{
+		MutexLock update_lock(update_mutex);
+
+		ERR_FAIL_COND_MSG(update_depth.load() == 0, "No update to end.");
+
+		if (update_depth.fetch_sub(1) > 1) {
+			return;
+		}
+
+		commands = update_commands;
+		update_commands.clear();
+	}
+
+	commit_commands(commands);
+}
+
+void BlipKitTrack::apply(const Dictionary &p_properties) {
+	const Array keys = p_properties.keys();
+
+	begin_update();
+
+	for (int i = 0; i < keys.size(); i++) {
+		const Variant &key = keys[i];
+		set(key, p_properties[key]);
+	}
+
+	end_update();
 }
 
 bool BlipKitTrack::has_divider(DividerGroup::ID p_id) {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	return dividers.has_divider(p_id);
 }
 
 PackedInt32Array BlipKitTrack::get_dividers() const {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	return dividers.get_dividers();
 }
@@ -568,13 +817,30 @@ DividerGroup::ID BlipKitTrack::add_divider(int p_tick_interval, Callable p_calla
 	ERR_FAIL_COND_V(p_tick_interval <= 0, 0);
 	ERR_FAIL_COND_V(p_callable.is_null(), 0);
 
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	return dividers.add_divider(p_tick_interval, p_callable);
 }
 
+DividerGroup::ID BlipKitTrack::add_interpreter_divider(const Ref<BlipKitInterpreter> &p_interpreter) {
+	ERR_FAIL_COND_V(p_interpreter.is_null(), 0);
+
+	BK_TRACK_SAFE_METHOD
+
+	return dividers.add_interpreter_divider(p_interpreter);
+}
+
+DividerGroup::ID BlipKitTrack::add_pattern_divider(int p_tick_interval, const PackedFloat32Array &p_notes) {
+	ERR_FAIL_COND_V(p_tick_interval <= 0, 0);
+	ERR_FAIL_COND_V(p_notes.is_empty(), 0);
+
+	BK_TRACK_SAFE_METHOD
+
+	return dividers.add_pattern_divider(p_tick_interval, p_notes);
+}
+
 void BlipKitTrack::remove_divider(DividerGroup::ID p_id) {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	ERR_FAIL_COND(not has_divider(p_id));
 
@@ -582,21 +848,229 @@ void BlipKitTrack::remove_divider(DividerGroup::ID p_id) {
 }
 
 void BlipKitTrack::reset_divider(DividerGroup::ID p_id, int p_tick_interval) {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	dividers.reset_divider(p_id, p_tick_interval);
 }
 
 void BlipKitTrack::clear_dividers() {
-	BK_THREAD_SAFE_METHOD
+	BK_TRACK_SAFE_METHOD
 
 	dividers.clear();
 }
 
+bool BlipKitTrack::push_command(const TrackCommand &p_command) {
+	// Counted before reading `playback` so `detach` can wait for the command.
+	command_pushes.fetch_add(1);
+
+	AudioStreamBlipKitPlayback *current = playback.load();
+	const bool is_pushed = current && current->push_command(p_command);
+
+	command_pushes.fetch_sub(1);
+
+	return is_pushed;
+}
+
+bool BlipKitTrack::push_commands(const TrackCommand *p_commands, uint32_t p_count) {
+	command_pushes.fetch_add(1);
+
+	AudioStreamBlipKitPlayback *current = playback.load();
+	const bool is_pushed = current && current->push_commands(p_commands, p_count);
+
+	command_pushes.fetch_sub(1);
+
+	return is_pushed;
+}
+
+bool BlipKitTrack::stage_command(const TrackCommand &p_command) {
+	AudioStreamBlipKitPlayback *current = get_playback();
+
+	// Applied at the next sample boundary with the other changes of a deferred sync callback.
+	if (current && current->record_command(p_command)) {
+		return true;
+	}
+
+	// The audio thread applies its changes directly.
+	if (update_depth.load(std::memory_order_relaxed) == 0 || AudioStreamBlipKitPlayback::mixing_playback) {
+		return false;
+	}
+
+	MutexLock update_lock(update_mutex);
+
+	if (update_depth.load() == 0) {
+		return false;
+	}
+
+	update_commands.push_back(p_command);
+
+	return true;
+}
+
+void BlipKitTrack::commit_update() {
+	AudioStreamBlipKitPlayback *current = get_playback();
+
+	if (current) {
+		current->commit_recorded_commands();
+	}
+
+	// Changes of the audio thread do not commit updates of other threads.
+	if (update_depth.load(std::memory_order_relaxed) == 0 || AudioStreamBlipKitPlayback::mixing_playback) {
+		return;
+	}
+
+	LocalVector<TrackCommand> commands;
+
+	{
+		MutexLock update_lock(update_mutex);
+
+		commands = update_commands;
+		update_commands.clear();
+	}
+
+	commit_commands(commands);
+}
+
+void BlipKitTrack::commit_commands(const LocalVector<TrackCommand> &p_commands) {
+	if (p_commands.is_empty()) {
+		return;
+	}
+
+	// Queue all changes at once so that they are applied by the same mix call.
+	if (push_commands(p_commands.ptr(), p_commands.size())) {
+		return;
+	}
+
+	// Not attached or not enough space in the queue.
+	BK_TRACK_SAFE_METHOD
+
+	for (const TrackCommand &command : p_commands) {
+		apply_command(command);
+	}
+}
+
+void BlipKitTrack::set_attr(BKEnum p_attribute, BKInt p_value) {
+	const TrackCommand command = {
+		.track = this,
+		.attribute = p_attribute,
+		.values = { p_value },
+	};
+
+	if (stage_command(command)) {
+		return;
+	}
+
+	// Queue change if attached to avoid blocking the audio thread.
+	if (push_command(command)) {
+		return;
+	}
+
+	BK_TRACK_SAFE_METHOD
+
+	apply_command(command);
+}
+
+void BlipKitTrack::set_ptr(BKEnum p_attribute, const BKInt *p_values, BKInt p_size) {
+	TrackCommand command = {
+		.track = this,
+		.attribute = p_attribute,
+		.size = p_size,
+	};
+
+	memcpy(command.values, p_values, p_size * sizeof(BKInt));
+
+	if (stage_command(command)) {
+		return;
+	}
+
+	// Queue change if attached to avoid blocking the audio thread.
+	if (push_command(command)) {
+		return;
+	}
+
+	BK_TRACK_SAFE_METHOD
+
+	apply_command(command);
+}
+
+void BlipKitTrack::apply_command(const TrackCommand &p_command) {
+	if (p_command.size > 0) {
+		BKSetPtr(&track, p_command.attribute, const_cast<BKInt *>(p_command.values), p_command.size * sizeof(BKInt));
+	} else {
+		apply_attr(p_command.attribute, p_command.values[0]);
+	}
+}
+
+void BlipKitTrack::apply_attr(BKEnum p_attribute, BKInt p_value) {
+	const int index = get_attribute_cache_index(p_attribute);
+
+	if (index >= 0) {
+		const uint32_t mask = 1 << index;
+
+		// Value is unchanged.
+		if ((attribute_cache_mask & mask) && attribute_cache[index] == p_value) {
+			return;
+		}
+
+		attribute_cache[index] = p_value;
+		attribute_cache_mask |= mask;
+	} else if (p_attribute == BK_NOTE) {
+		// Has to be attached before playing a note.
+		update_parked(p_value);
+	}
+
+	BKSetAttr(&track, p_attribute, p_value);
+}
+
+int BlipKitTrack::get_attribute_cache_index(BKEnum p_attribute) {
+	// Setting a note again triggers it again, so it is not cached.
+	switch (p_attribute) {
+		case BK_MASTER_VOLUME:
+			return 0;
+		case BK_VOLUME:
+			return 1;
+		case BK_PANNING:
+			return 2;
+		case BK_DUTY_CYCLE:
+			return 3;
+		case BK_PITCH:
+			return 4;
+		case BK_PHASE_WRAP:
+			return 5;
+		case BK_EFFECT_VOLUME_SLIDE:
+			return 6;
+		case BK_EFFECT_PANNING_SLIDE:
+			return 7;
+		case BK_EFFECT_PORTAMENTO:
+			return 8;
+		case BK_EFFECT_DIVIDER:
+			return 9;
+		case BK_ARPEGGIO_DIVIDER:
+			return 10;
+		case BK_INSTRUMENT_DIVIDER:
+			return 11;
+		case BK_SAMPLE_PITCH:
+			return 12;
+		default:
+			return -1;
+	}
+}
+
+void BlipKitTrack::flush_commands() const {
+	AudioStreamBlipKitPlayback *current = get_playback();
+
+	if (current) {
+		current->flush_commands();
+	}
+}
+
 void BlipKitTrack::update_waveform(Waveform p_waveform) {
 	ERR_FAIL_INDEX(p_waveform, WAVEFORM_MAX);
 
-	BK_THREAD_SAFE_METHOD
+	// Changing the waveform may reset other attributes.
+	attribute_cache_mask = 0;
+
+	// Unlinks or links the track.
+	OrderedMutexLock<RecursiveMutex, 2> binding_lock({ get_binding_mutex(custom_waveform), get_binding_mutex(sample) });
 
 	switch (p_waveform) {
 		case WAVEFORM_SQUARE:
@@ -772,14 +1246,22 @@ void BlipKitTrack::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_sample"), &BlipKitTrack::get_sample);
 	ClassDB::bind_method(D_METHOD("set_sample_pitch"), &BlipKitTrack::set_sample_pitch);
 	ClassDB::bind_method(D_METHOD("get_sample_pitch"), &BlipKitTrack::get_sample_pitch);
+	ClassDB::bind_method(D_METHOD("set_interpreter"), &BlipKitTrack::set_interpreter);
+	ClassDB::bind_method(D_METHOD("get_interpreter"), &BlipKitTrack::get_interpreter);
 	ClassDB::bind_method(D_METHOD("attach", "playback"), &BlipKitTrack::attach);
 	ClassDB::bind_method(D_METHOD("detach"), &BlipKitTrack::detach);
 	ClassDB::bind_method(D_METHOD("release"), &BlipKitTrack::release);
 	ClassDB::bind_method(D_METHOD("mute"), &BlipKitTrack::mute);
 	ClassDB::bind_method(D_METHOD("reset"), &BlipKitTrack::reset);
+	ClassDB::bind_method(D_METHOD("get_track_id"), &BlipKitTrack::get_track_id);
+	ClassDB::bind_method(D_METHOD("begin_update"), &BlipKitTrack::begin_update);
+	ClassDB::bind_method(D_METHOD("end_update"), &BlipKitTrack::end_update);
+	ClassDB::bind_method(D_METHOD("apply", "properties"), &BlipKitTrack::apply);
 	ClassDB::bind_method(D_METHOD("get_dividers"), &BlipKitTrack::get_dividers);
 	ClassDB::bind_method(D_METHOD("has_divider", "id"), &BlipKitTrack::has_divider);
 	ClassDB::bind_method(D_METHOD("add_divider", "tick_interval", "callback"), &BlipKitTrack::add_divider);
+	ClassDB::bind_method(D_METHOD("add_interpreter_divider", "interpreter"), &BlipKitTrack::add_interpreter_divider);
+	ClassDB::bind_method(D_METHOD("add_pattern_divider", "tick_interval", "notes"), &BlipKitTrack::add_pattern_divider);
 	ClassDB::bind_method(D_METHOD("remove_divider", "id"), &BlipKitTrack::remove_divider);
 	ClassDB::bind_method(D_METHOD("clear_dividers"), &BlipKitTrack::clear_dividers);
 	ClassDB::bind_method(D_METHOD("reset_divider", "id", "tick_interval"), &BlipKitTrack::reset_divider, DEFVAL(0));
@@ -803,6 +1285,7 @@ void BlipKitTrack::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "custom_waveform"), "set_custom_waveform", "get_custom_waveform");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "sample"), "set_sample", "get_sample");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "sample_pitch"), "set_sample_pitch", "get_sample_pitch");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "interpreter", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NONE), "set_interpreter", "get_interpreter");
 
 	BIND_ENUM_CONSTANT(WAVEFORM_SQUARE);
 	BIND_ENUM_CONSTANT(WAVEFORM_TRIANGLE);
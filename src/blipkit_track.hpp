@@ -4,8 +4,12 @@
 #include "blipkit_sample.hpp"
 #include "blipkit_waveform.hpp"
 #include "divider.hpp"
+#include "mutex.hpp"
+#include "track_command.hpp"
 #include <BlipKit.h>
+#include <atomic>
 #include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/packed_float32_array.hpp>
 #include <godot_cpp/variant/packed_string_array.hpp>
@@ -19,6 +23,7 @@ class AudioStreamBlipKitPlayback;
 
 class BlipKitTrack : public RefCounted {
 	GDCLASS(BlipKitTrack, RefCounted)
+	friend class AudioStreamBlipKitPlayback;
 
 public:
 	enum Waveform {
@@ -137,14 +142,41 @@ public:
 	static constexpr int ARPEGGIO_MAX = BK_MAX_ARPEGGIO;
 
 private:
+	static constexpr int ATTRIBUTE_CACHE_SIZE = 13;
+
+	// Locks the attached playback and applies pending commands.
+	class Lock {
+	private:
+		AudioStreamBlipKitPlayback *playback = nullptr;
+
+	public:
+		Lock(const BlipKitTrack *p_track);
+		~Lock();
+	};
+
 	BKTrack track;
 	Ref<BlipKitInstrument> instrument;
 	Ref<BlipKitWaveform> custom_waveform;
 	Ref<BlipKitSample> sample;
-	PackedFloat32Array arpeggio;
+	float arpeggio[ARPEGGIO_MAX] = { 0.0 };
+	int arpeggio_size = 0;
 	DividerGroup dividers;
-	AudioStreamBlipKitPlayback *playback = nullptr;
+	Ref<BlipKitInterpreter> interpreter;
+	BKDivider interpreter_divider = { { 0 } };
+	int interpreter_counter = 0;
+	std::atomic<AudioStreamBlipKitPlayback *> playback = nullptr; // Read without lock when queuing commands.
+	std::atomic<uint32_t> command_pushes = 0; // Number of commands being queued.
+	int track_id = -1; // Assigned by `playback` while attached.
+	int track_index = -1; // Index in the tracks of `playback`.
+	RecursiveMutex update_mutex; // Guards `update_commands`.
+	LocalVector<TrackCommand> update_commands; // Staged between `begin_update` and `end_update`.
+	std::atomic<uint32_t> update_depth = 0;
+	// Last values set with `BKSetAttr` to skip unchanged values.
+	BKInt attribute_cache[ATTRIBUTE_CACHE_SIZE] = { 0 };
+	uint32_t attribute_cache_mask = 0;
 	bool master_volume_changed = false;
+	bool parked = false; // Detached from the context of `playback` while silent.
+	bool parking = false; // Parked by `playback` after generating frames.
 
 public:
 	BlipKitTrack();
@@ -152,6 +184,8 @@ public:
 
 	static Ref<BlipKitTrack> create_with_waveform(Waveform p_waveform);
 
+	int get_track_id() const;
+
 	void set_waveform(Waveform p_waveform);
 	Waveform get_waveform() const;
 	void set_duty_cycle(int p_duty_cycle);
@@ -184,6 +218,8 @@ public:
 
 	void set_arpeggio(const PackedFloat32Array &p_arpeggio);
 	PackedFloat32Array get_arpeggio() const;
+	// Same as `set_arpeggio` but without allocating an array.
+	void set_arpeggio_values(const float *p_values, int p_count);
 	void set_arpeggio_divider(int p_arpeggio_divider);
 	int get_arpeggio_divider() const;
 
@@ -200,6 +236,9 @@ public:
 	void set_sample_pitch(float p_sample_pitch);
 	float get_sample_pitch() const;
 
+	void set_interpreter(const Ref<BlipKitInterpreter> &p_interpreter);
+	Ref<BlipKitInterpreter> get_interpreter() const;
+
 	void attach(AudioStreamBlipKit *p_stream);
 	void detach();
 
@@ -208,15 +247,55 @@ public:
 
 	void reset();
 
+	void begin_update();
+	void end_update();
+	void apply(const Dictionary &p_properties);
+
 	PackedInt32Array get_dividers() const;
 	bool has_divider(DividerGroup::ID p_id);
 	DividerGroup::ID add_divider(int p_tick_interval, Callable p_callable);
+	DividerGroup::ID add_interpreter_divider(const Ref<BlipKitInterpreter> &p_interpreter);
+	DividerGroup::ID add_pattern_divider(int p_tick_interval, const PackedFloat32Array &p_notes);
 	void remove_divider(DividerGroup::ID p_id);
 	void reset_divider(DividerGroup::ID p_id, int p_tick_interval = 0);
 	void clear_dividers();
 
 protected:
+	static BKEnum interpreter_callback(BKCallbackInfo *p_info, void *p_user_info);
+
+	// Has to be called with the track locked.
 	void update_waveform(Waveform p_waveform);
+	Waveform read_waveform() const;
+
+	// Attaches the track and its dividers to the context of `playback`.
+	void attach_context();
+	void detach_context();
+	// Attaches the track itself to the context of `playback`.
+	void attach_track();
+	// Parks the track if `p_note` is silent, or attaches it again.
+	void update_parked(BKInt p_note);
+	void update_parked();
+	// Detaches the silent track from the context of `playback`.
+	void park();
+
+	// Returns the attached playback. Has to be called with the track locked.
+	_ALWAYS_INLINE_ AudioStreamBlipKitPlayback *get_playback() const { return playback.load(std::memory_order_relaxed); }
+
+	// Queues the command if attached. Returns `false` if it has to be applied directly.
+	bool push_command(const TrackCommand &p_command);
+	bool push_commands(const TrackCommand *p_commands, uint32_t p_count);
+	// Records or stages the command while in a deferred sync callback or updating. Returns `false` otherwise.
+	bool stage_command(const TrackCommand &p_command);
+	// Commits staged commands, so that following changes are not applied before them.
+	void commit_update();
+	void commit_commands(const LocalVector<TrackCommand> &p_commands);
+	void set_attr(BKEnum p_attribute, BKInt p_value);
+	void set_ptr(BKEnum p_attribute, const BKInt *p_values, BKInt p_size);
+	void apply_command(const TrackCommand &p_command);
+	// Sets the attribute directly. Has to be called with the track locked.
+	void apply_attr(BKEnum p_attribute, BKInt p_value);
+	static int get_attribute_cache_index(BKEnum p_attribute);
+	void flush_commands() const;
 
 	static void _bind_methods();
 	String _to_string() const;
@@ -0,0 +1,239 @@
+#include "blipkit_voice_pool.hpp"
+#include "audio_stream_blipkit.hpp"
+
+#define BK_VOICE_POOL_SAFE_METHOD Lock _voice_pool_lock_(this);
+
+using namespace BlipKit;
+using namespace godot;
+
+BlipKitVoicePool::Lock::Lock(const BlipKitVoicePool *p_voice_pool) :
+		playback(p_voice_pool->playback.ptr()) {
+	// Interpreters are not advanced by the audio thread if not attached.
+	if (playback) {
+		playback->lock();
+	}
+}
+
+BlipKitVoicePool::Lock::~Lock() {
+	if (playback) {
+		playback->unlock();
+	}
+}
+
+BlipKitVoicePool::BlipKitVoicePool() {
+	set_voice_count(VOICE_COUNT_DEFAULT);
+}
+
+BlipKitVoicePool::~BlipKitVoicePool() {
+	detach();
+}
+
+int BlipKitVoicePool::find_voice(int p_priority) const {
+	int found = -1;
+
+	for (uint32_t i = 0; i < voices.size(); i++) {
+		const Voice &voice = voices[i];
+
+		if (not is_playing(voice)) {
+			return i;
+		}
+
+		// Steal the voice with the lowest priority, and the oldest one of those.
+		if (voice.priority > p_priority) {
+			continue;
+		}
+
+		if (found < 0) {
+			found = i;
+			continue;
+		}
+
+		const Voice &other = voices[found];
+
+		if (voice.priority < other.priority || (voice.priority == other.priority && voice.order < other.order)) {
+			found = i;
+		}
+	}
+
+	return found;
+}
+
+void BlipKitVoicePool::stop_voice(Voice &p_voice) {
+	if (not p_voice.active) {
+		return;
+	}
+
+	// Remove the interpreter from the audio thread before changing it.
+	p_voice.track->set_interpreter(nullptr);
+	p_voice.track->mute();
+	p_voice.active = false;
+}
+
+void BlipKitVoicePool::set_voice_count(int p_voice_count) {
+	BK_VOICE_POOL_SAFE_METHOD
+
+	const uint32_t count = CLAMP(p_voice_count, 1, VOICE_COUNT_MAX);
+	const uint32_t old_count = voices.size();
+
+	for (uint32_t i = count; i < old_count; i++) {
+		Voice &voice = voices[i];
+		stop_voice(voice);
+		voice.track->detach();
+	}
+
+	voices.resize(count);
+
+	for (uint32_t i = old_count; i < count; i++) {
+		Voice &voice = voices[i];
+		voice.track.instantiate();
+		voice.interpreter.instantiate();
+		voice.interpreter->set_slot_bank(slot_bank);
+
+		if (stream.is_valid()) {
+			voice.track->attach(stream.ptr());
+		}
+	}
+}
+
+int BlipKitVoicePool::get_voice_count() const {
+	return voices.size();
+}
+
+void BlipKitVoicePool::set_slot_bank(const Ref<BlipKitSlotBank> &p_slot_bank) {
+	BK_VOICE_POOL_SAFE_METHOD
+
+	slot_bank = p_slot_bank;
+
+	for (Voice &voice : voices) {
+		voice.interpreter->set_slot_bank(slot_bank);
+	}
+}
+
+Ref<BlipKitSlotBank> BlipKitVoicePool::get_slot_bank() const {
+	return slot_bank;
+}
+
+void BlipKitVoicePool::attach(AudioStreamBlipKit *p_stream) {
+	ERR_FAIL_NULL(p_stream);
+
+	detach();
+
+	stream = Ref<AudioStreamBlipKit>(p_stream);
+	playback = p_stream->get_playback();
+
+	for (Voice &voice : voices) {
+		voice.track->attach(p_stream);
+	}
+}
+
+void BlipKitVoicePool::detach() {
+	if (stream.is_null()) {
+		return;
+	}
+
+	for (Voice &voice : voices) {
+		stop_voice(voice);
+		voice.track->detach();
+	}
+
+	stream.unref();
+	playback.unref();
+}
+
+int BlipKitVoicePool::play(const Ref<BlipKitBytecode> &p_byte_code, const String &p_start_label, int p_priority) {
+	ERR_FAIL_COND_V(p_byte_code.is_null(), -1);
+	// Checked before a playing voice is stopped.
+	ERR_FAIL_COND_V_MSG(not p_byte_code->is_valid(), -1, p_byte_code->get_error_message());
+	ERR_FAIL_COND_V_MSG(not p_start_label.is_empty() && not p_byte_code->has_label(p_start_label), -1, vformat("Label '%s' does not exist.", p_start_label));
+
+	BK_VOICE_POOL_SAFE_METHOD
+
+	const int index = find_voice(p_priority);
+
+	// All voices play with a higher priority.
+	if (index < 0) {
+		return -1;
+	}
+
+	Voice &voice = voices[index];
+	stop_voice(voice);
+
+	if (not voice.interpreter->load_byte_code(p_byte_code, p_start_label)) {
+		return -1;
+	}
+
+	voice.track->reset();
+	voice.priority = p_priority;
+	voice.order = play_order++;
+	voice.active = true;
+	voice.track->set_interpreter(voice.interpreter);
+
+	return index;
+}
+
+void BlipKitVoicePool::stop(int p_voice) {
+	ERR_FAIL_INDEX(p_voice, int(voices.size()));
+
+	BK_VOICE_POOL_SAFE_METHOD
+
+	stop_voice(voices[p_voice]);
+}
+
+void BlipKitVoicePool::stop_all() {
+	BK_VOICE_POOL_SAFE_METHOD
+
+	for (Voice &voice : voices) {
+		stop_voice(voice);
+	}
+}
+
+bool BlipKitVoicePool::is_voice_playing(int p_voice) const {
+	ERR_FAIL_INDEX_V(p_voice, int(voices.size()), false);
+
+	BK_VOICE_POOL_SAFE_METHOD
+
+	return is_playing(voices[p_voice]);
+}
+
+int BlipKitVoicePool::get_playing_count() const {
+	BK_VOICE_POOL_SAFE_METHOD
+
+	int count = 0;
+
+	for (const Voice &voice : voices) {
+		count += is_playing(voice);
+	}
+
+	return count;
+}
+
+Ref<BlipKitTrack> BlipKitVoicePool::get_track(int p_voice) const {
+	ERR_FAIL_INDEX_V(p_voice, int(voices.size()), nullptr);
+
+	return voices[p_voice].track;
+}
+
+void BlipKitVoicePool::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_voice_count", "voice_count"), &BlipKitVoicePool::set_voice_count);
+	ClassDB::bind_method(D_METHOD("get_voice_count"), &BlipKitVoicePool::get_voice_count);
+	ClassDB::bind_method(D_METHOD("set_slot_bank", "slot_bank"), &BlipKitVoicePool::set_slot_bank);
+	ClassDB::bind_method(D_METHOD("get_slot_bank"), &BlipKitVoicePool::get_slot_bank);
+	ClassDB::bind_method(D_METHOD("attach", "playback"), &BlipKitVoicePool::attach);
+	ClassDB::bind_method(D_METHOD("detach"), &BlipKitVoicePool::detach);
+	ClassDB::bind_method(D_METHOD("play", "byte_code", "start_label", "priority"), &BlipKitVoicePool::play, DEFVAL(""), DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("stop", "voice"), &BlipKitVoicePool::stop);
+	ClassDB::bind_method(D_METHOD("stop_all"), &BlipKitVoicePool::stop_all);
+	ClassDB::bind_method(D_METHOD("is_voice_playing", "voice"), &BlipKitVoicePool::is_voice_playing);
+	ClassDB::bind_method(D_METHOD("get_playing_count"), &BlipKitVoicePool::get_playing_count);
+	ClassDB::bind_method(D_METHOD("get_track", "voice"), &BlipKitVoicePool::get_track);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "voice_count"), "set_voice_count", "get_voice_count");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "slot_bank"), "set_slot_bank", "get_slot_bank");
+
+	BIND_CONSTANT(VOICE_COUNT_DEFAULT);
+	BIND_CONSTANT(VOICE_COUNT_MAX);
+}
+
+String BlipKitVoicePool::_to_string() const {
+	return vformat("<BlipKitVoicePool#%d>", get_instance_id());
+}
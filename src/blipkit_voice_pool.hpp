@@ -0,0 +1,82 @@
+#pragma once
+
+#include "blipkit_bytecode.hpp"
+#include "blipkit_interpreter.hpp"
+#include "blipkit_slot_bank.hpp"
+#include "blipkit_track.hpp"
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+
+using namespace godot;
+
+namespace BlipKit {
+
+class AudioStreamBlipKit;
+class AudioStreamBlipKitPlayback;
+
+// Preallocated tracks and interpreters for playing byte code without allocations.
+class BlipKitVoicePool : public RefCounted {
+	GDCLASS(BlipKitVoicePool, RefCounted)
+
+public:
+	static constexpr int VOICE_COUNT_DEFAULT = 8;
+	static constexpr int VOICE_COUNT_MAX = 256;
+
+private:
+	// Locks the playback as interpreter states are changed by the audio thread.
+	class Lock {
+	private:
+		AudioStreamBlipKitPlayback *playback = nullptr;
+
+	public:
+		Lock(const BlipKitVoicePool *p_voice_pool);
+		~Lock();
+	};
+
+	struct Voice {
+		Ref<BlipKitTrack> track;
+		Ref<BlipKitInterpreter> interpreter;
+		int priority = 0;
+		uint64_t order = 0; // Play order used to find the oldest voice.
+		bool active = false;
+	};
+
+	LocalVector<Voice> voices;
+	Ref<AudioStreamBlipKit> stream;
+	Ref<AudioStreamBlipKitPlayback> playback;
+	Ref<BlipKitSlotBank> slot_bank;
+	uint64_t play_order = 0;
+
+	_ALWAYS_INLINE_ static bool is_playing(const Voice &p_voice) {
+		return p_voice.active && p_voice.interpreter->get_state() == BlipKitInterpreter::OK_RUNNING;
+	}
+
+	int find_voice(int p_priority) const;
+	void stop_voice(Voice &p_voice);
+
+public:
+	BlipKitVoicePool();
+	~BlipKitVoicePool();
+
+	void set_voice_count(int p_voice_count);
+	int get_voice_count() const;
+	void set_slot_bank(const Ref<BlipKitSlotBank> &p_slot_bank);
+	Ref<BlipKitSlotBank> get_slot_bank() const;
+
+	void attach(AudioStreamBlipKit *p_stream);
+	void detach();
+
+	int play(const Ref<BlipKitBytecode> &p_byte_code, const String &p_start_label = "", int p_priority = 0);
+	void stop(int p_voice);
+	void stop_all();
+
+	bool is_voice_playing(int p_voice) const;
+	int get_playing_count() const;
+	Ref<BlipKitTrack> get_track(int p_voice) const;
+
+protected:
+	static void _bind_methods();
+	String _to_string() const;
+};
+
+} // namespace BlipKit
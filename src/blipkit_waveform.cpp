@@ -24,7 +24,9 @@ BlipKitWaveform::BlipKitWaveform() {
 }
 
 BlipKitWaveform::~BlipKitWaveform() {
-	BK_THREAD_SAFE_METHOD
+	// Only tracks holding a reference use the data, so it is disposed even
+	// if not all streams could be locked.
+	AudioStreamBlipKitPlayback::ResourceLock resource_lock;
 
 	BKDispose(&data);
 }
@@ -64,7 +66,8 @@ void BlipKitWaveform::set_frames(const PackedFloat32Array &p_frames, bool p_norm
 		}
 	}
 
-	BK_THREAD_SAFE_METHOD
+	BK_RESOURCE_SAFE_METHOD
+	MutexLock binding_lock(binding_mutex);
 
 	frames.resize(size);
 
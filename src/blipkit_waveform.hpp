@@ -1,5 +1,6 @@
 #pragma once
 
+#include "mutex.hpp"
 #include <BlipKit.h>
 #include <godot_cpp/classes/resource.hpp>
 #include <godot_cpp/templates/local_vector.hpp>
@@ -17,6 +18,7 @@ public:
 
 private:
 	BKData data;
+	RecursiveMutex binding_mutex; // Guards the tracks linked to `data`.
 	LocalVector<BKFrame> frames;
 
 public:
@@ -26,6 +28,8 @@ public:
 	static Ref<BlipKitWaveform> create_with_frames(const PackedFloat32Array &p_frames, bool p_normalize = false, float p_amplitude = 1.0);
 
 	_ALWAYS_INLINE_ BKData *get_data() { return &data; };
+	// Has to be locked while linking or unlinking a track.
+	_ALWAYS_INLINE_ RecursiveMutex *get_binding_mutex() { return &binding_mutex; };
 	_ALWAYS_INLINE_ int size() const { return frames.size(); };
 	_ALWAYS_INLINE_ bool is_valid() const { return !frames.is_empty(); };
 
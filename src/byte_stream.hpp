@@ -127,6 +127,10 @@ public:
 	_ALWAYS_INLINE_ uint32_t get_position() const { return pointer; }
 	_ALWAYS_INLINE_ uint32_t get_available_bytes() const { return count - pointer; }
 	_ALWAYS_INLINE_ void seek(uint32_t p_offset) { pointer = MIN(p_offset, size()); }
+	_ALWAYS_INLINE_ void truncate(uint32_t p_size) {
+		count = MIN(count, p_size);
+		pointer = MIN(pointer, count);
+	}
 
 	_ALWAYS_INLINE_ const uint8_t *ptr() const { return bytes.ptr(); }
 	Vector<uint8_t> get_bytes() const;
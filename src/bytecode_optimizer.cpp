@@ -0,0 +1,435 @@
+#include "bytecode_optimizer.hpp"
+#include "blipkit_assembler.hpp"
+#include "bytecode_program.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace BlipKit;
+using namespace godot;
+
+typedef BlipKitAssembler::Opcode Opcode;
+
+static constexpr uint32_t CALL_SIZE = sizeof(uint8_t) + sizeof(int32_t);
+
+static uint16_t read_u16(const uint8_t *p_ptr) {
+	return uint16_t(p_ptr[0]) | (uint16_t(p_ptr[1]) << 8);
+}
+
+static void write_u16(uint8_t *p_ptr, uint16_t p_value) {
+	p_ptr[0] = p_value & 0xFF;
+	p_ptr[1] = (p_value >> 8) & 0xFF;
+}
+
+static int32_t read_s32(const uint8_t *p_ptr) {
+	return int32_t(uint32_t(p_ptr[0]) | (uint32_t(p_ptr[1]) << 8) | (uint32_t(p_ptr[2]) << 16) | (uint32_t(p_ptr[3]) << 24));
+}
+
+static void write_s32(uint8_t *p_ptr, int32_t p_value) {
+	for (uint32_t i = 0; i < sizeof(int32_t); i++) {
+		p_ptr[i] = (uint32_t(p_value) >> (i * 8)) & 0xFF;
+	}
+}
+
+// Instructions which only set a track attribute and are overwritten by the
+// same instruction without a tick in between.
+static bool is_attribute_setter(uint8_t p_opcode) {
+	switch (p_opcode) {
+		case Opcode::OP_VOLUME:
+		case Opcode::OP_MASTER_VOLUME:
+		case Opcode::OP_PANNING:
+		case Opcode::OP_DUTY_CYCLE:
+		case Opcode::OP_PITCH:
+		case Opcode::OP_PHASE_WRAP:
+		case Opcode::OP_EFFECT_DIV:
+		case Opcode::OP_ARPEGGIO:
+		case Opcode::OP_ARPEGGIO_DIV:
+		case Opcode::OP_STEP_TICKS:
+		case Opcode::OP_INSTRUMENT_DIV:
+		case Opcode::OP_SAMPLE_PITCH: {
+			return true;
+		} break;
+		default: {
+			return false;
+		} break;
+	}
+}
+
+void BytecodeOptimizer::set_code(const uint8_t *p_code, uint32_t p_size) {
+	code.resize(p_size);
+	memcpy(code.ptr(), p_code, p_size);
+}
+
+void BytecodeOptimizer::add_entry(uint32_t p_offset) {
+	entries.push_back(p_offset);
+}
+
+uint32_t BytecodeOptimizer::find_instruction(uint32_t p_offset) const {
+	const Instruction *begin = instructions.ptr();
+	const Instruction *end = begin + instructions.size();
+	const Instruction *instruction = std::lower_bound(begin, end, p_offset, [](const Instruction &p_instruction, uint32_t p_offset) {
+		return p_instruction.offset < p_offset;
+	});
+
+	if (instruction == end || instruction->offset != p_offset) {
+		return INVALID_INDEX;
+	}
+
+	return instruction - begin;
+}
+
+bool BytecodeOptimizer::decode() {
+	const uint32_t size = code.size();
+	uint32_t offset = 0;
+
+	instructions.clear();
+	entry_indices.clear();
+	has_delays = false;
+
+	while (offset < size) {
+		Instruction instruction;
+		instruction.offset = offset;
+		instruction.opcode = code[offset];
+
+		if (instruction.opcode >= Opcode::OP_MAX) {
+			return false;
+		}
+
+		uint32_t argument_size = BytecodeProgram::get_argument_size(instruction.opcode);
+
+		if (instruction.opcode == Opcode::OP_ARPEGGIO && offset + 1 < size) {
+			argument_size += code[offset + 1] * sizeof(uint16_t);
+		}
+
+		instruction.size = sizeof(uint8_t) + argument_size;
+
+		if (offset + instruction.size > size) {
+			return false;
+		}
+
+		if (instruction.opcode == Opcode::OP_DELAY_TICK || instruction.opcode == Opcode::OP_DELAY_STEP) {
+			has_delays = true;
+		}
+
+		offset += instruction.size;
+		instructions.push_back(instruction);
+	}
+
+	if (instructions.is_empty() || instructions[instructions.size() - 1].opcode != Opcode::OP_HALT) {
+		return false;
+	}
+
+	// Resolve jump targets relative to the position of the address.
+	for (Instruction &instruction : instructions) {
+		if (instruction.opcode != Opcode::OP_JUMP && instruction.opcode != Opcode::OP_CALL) {
+			continue;
+		}
+
+		const int64_t address_position = instruction.offset + sizeof(uint8_t);
+		const int64_t position = address_position + read_s32(&code[address_position]);
+
+		if (position < 0 || position >= size) {
+			return false;
+		}
+
+		instruction.target = find_instruction(position);
+
+		if (instruction.target == INVALID_INDEX) {
+			return false;
+		}
+
+		instructions[instruction.target].is_target = true;
+	}
+
+	for (const uint32_t entry : entries) {
+		const uint32_t index = find_instruction(entry);
+
+		if (index == INVALID_INDEX) {
+			return false;
+		}
+
+		instructions[index].is_target = true;
+		entry_indices.push_back(index);
+	}
+
+	// The interpreter starts at the beginning if no label is given.
+	instructions[0].is_target = true;
+
+	return true;
+}
+
+void BytecodeOptimizer::emit() {
+	const uint32_t count = instructions.size();
+	LocalVector<uint32_t> offsets;
+	offsets.resize(count);
+	uint32_t size = 0;
+
+	for (uint32_t i = 0; i < count; i++) {
+		const Instruction &instruction = instructions[i];
+
+		if (not instruction.removed) {
+			offsets[i] = size;
+			size += instruction.replaced ? instruction.replacement.size() : instruction.size;
+		}
+	}
+
+	// Removed instructions continue with the next one.
+	uint32_t next_offset = size;
+
+	for (uint32_t i = count; i-- > 0;) {
+		if (instructions[i].removed) {
+			offsets[i] = next_offset;
+		} else {
+			next_offset = offsets[i];
+		}
+	}
+
+	LocalVector<uint8_t> new_code;
+	new_code.resize(size);
+
+	for (uint32_t i = 0; i < count; i++) {
+		const Instruction &instruction = instructions[i];
+
+		if (instruction.removed) {
+			continue;
+		}
+
+		uint8_t *ptrw = &new_code[offsets[i]];
+
+		if (instruction.replaced) {
+			memcpy(ptrw, instruction.replacement.ptr(), instruction.replacement.size());
+			continue;
+		}
+
+		memcpy(ptrw, &code[instruction.offset], instruction.size);
+
+		if (instruction.target != INVALID_INDEX) {
+			const int32_t address_position = offsets[i] + sizeof(uint8_t);
+			write_s32(&ptrw[1], int32_t(offsets[instruction.target]) - address_position);
+		}
+	}
+
+	for (uint32_t i = 0; i < entries.size(); i++) {
+		entries[i] = offsets[entry_indices[i]];
+	}
+
+	code = new_code;
+}
+
+bool BytecodeOptimizer::merge_ticks() {
+	// Ticks are part of delay sequences and cannot be merged.
+	if (has_delays) {
+		return false;
+	}
+
+	bool changed = false;
+
+	for (uint32_t i = 0; i + 1 < instructions.size(); i++) {
+		Instruction &instruction = instructions[i];
+
+		if (instruction.opcode != Opcode::OP_TICK && instruction.opcode != Opcode::OP_STEP) {
+			continue;
+		}
+
+		// Merge following ticks which are not jumped to.
+		uint32_t ticks = read_u16(&code[instruction.offset + 1]);
+		uint32_t j = i + 1;
+
+		for (; j < instructions.size(); j++) {
+			const Instruction &next = instructions[j];
+
+			if (next.opcode != instruction.opcode || next.is_target) {
+				break;
+			}
+
+			const uint32_t next_ticks = read_u16(&code[next.offset + 1]);
+
+			if (ticks + next_ticks > UINT16_MAX) {
+				break;
+			}
+
+			ticks += next_ticks;
+			instructions[j].removed = true;
+			stats.ticks_merged++;
+		}
+
+		if (j > i + 1) {
+			write_u16(&code[instruction.offset + 1], ticks);
+			changed = true;
+		}
+
+		i = j - 1;
+	}
+
+	return changed;
+}
+
+bool BytecodeOptimizer::remove_redundant_jumps() {
+	bool changed = false;
+
+	for (uint32_t i = 0; i < instructions.size(); i++) {
+		Instruction &instruction = instructions[i];
+
+		if (instruction.opcode == Opcode::OP_JUMP && instruction.target == i + 1) {
+			instruction.removed = true;
+			stats.jumps_removed++;
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+bool BytecodeOptimizer::remove_unreachable() {
+	bool changed = false;
+	bool reachable = true;
+
+	// Keep the terminating `OP_HALT`.
+	for (uint32_t i = 0; i + 1 < instructions.size(); i++) {
+		Instruction &instruction = instructions[i];
+
+		if (instruction.is_target) {
+			reachable = true;
+		}
+
+		if (not reachable) {
+			instruction.removed = true;
+			stats.unreachable_removed++;
+			changed = true;
+			continue;
+		}
+
+		switch (instruction.opcode) {
+			case Opcode::OP_HALT:
+			case Opcode::OP_JUMP:
+			case Opcode::OP_RETURN: {
+				reachable = false;
+			} break;
+			default: {
+				// Continues with the next instruction.
+			} break;
+		}
+	}
+
+	return changed;
+}
+
+bool BytecodeOptimizer::remove_overwritten() {
+	bool changed = false;
+
+	for (uint32_t i = 0; i + 1 < instructions.size(); i++) {
+		Instruction &instruction = instructions[i];
+
+		if (is_attribute_setter(instruction.opcode) && instructions[i + 1].opcode == instruction.opcode) {
+			instruction.removed = true;
+			stats.overwritten_removed++;
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+bool BytecodeOptimizer::inline_calls() {
+	bool changed = false;
+
+	for (Instruction &instruction : instructions) {
+		if (instruction.opcode != Opcode::OP_CALL) {
+			continue;
+		}
+
+		// Find subroutines not larger than the call instruction, so the code does not grow.
+		uint32_t body_size = 0;
+		uint32_t end = instruction.target;
+		bool is_inlinable = true;
+
+		for (; instructions[end].opcode != Opcode::OP_RETURN; end++) {
+			const Instruction &body = instructions[end];
+
+			switch (body.opcode) {
+				case Opcode::OP_HALT:
+				case Opcode::OP_TICK:
+				case Opcode::OP_STEP:
+				case Opcode::OP_DELAY_TICK:
+				case Opcode::OP_DELAY_STEP:
+				case Opcode::OP_JUMP:
+				case Opcode::OP_CALL: {
+					is_inlinable = false;
+				} break;
+				default: {
+					body_size += body.size;
+				} break;
+			}
+
+			if (not is_inlinable || body_size > CALL_SIZE) {
+				is_inlinable = false;
+				break;
+			}
+		}
+
+		if (not is_inlinable) {
+			continue;
+		}
+
+		if (body_size) {
+			const uint32_t body_offset = instructions[instruction.target].offset;
+			instruction.replacement.resize(body_size);
+			memcpy(instruction.replacement.ptr(), &code[body_offset], body_size);
+			instruction.replaced = true;
+		} else {
+			instruction.removed = true;
+		}
+
+		stats.calls_inlined++;
+		changed = true;
+	}
+
+	return changed;
+}
+
+bool BytecodeOptimizer::optimize(Level p_level) {
+	stats = Stats();
+	stats.size_before = code.size();
+	stats.size_after = code.size();
+
+	if (p_level == LEVEL_NONE) {
+		return true;
+	}
+
+	if (not decode()) {
+		return false;
+	}
+
+	typedef bool (BytecodeOptimizer::*Pass)();
+	LocalVector<Pass> passes;
+
+	if (p_level >= LEVEL_FULL) {
+		passes.push_back(&BytecodeOptimizer::inline_calls);
+	}
+
+	passes.push_back(&BytecodeOptimizer::merge_ticks);
+	passes.push_back(&BytecodeOptimizer::remove_redundant_jumps);
+	passes.push_back(&BytecodeOptimizer::remove_unreachable);
+	passes.push_back(&BytecodeOptimizer::remove_overwritten);
+
+	// Repeat until nothing changes, as passes can enable each other.
+	for (uint32_t i = 0; i < PASS_COUNT_MAX; i++) {
+		bool changed = false;
+
+		for (const Pass pass : passes) {
+			if ((this->*pass)()) {
+				emit();
+				// Emitted code is always decodable.
+				decode();
+				changed = true;
+			}
+		}
+
+		if (not changed) {
+			break;
+		}
+	}
+
+	stats.size_after = code.size();
+
+	return true;
+}
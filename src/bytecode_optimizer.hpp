@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <godot_cpp/templates/local_vector.hpp>
+
+using namespace godot;
+
+namespace BlipKit {
+
+// Peephole optimizer for the code section of compiled byte code. Jump offsets
+// have to be resolved and the code has to end with `OP_HALT`.
+class BytecodeOptimizer {
+public:
+	enum Level {
+		LEVEL_NONE,
+		LEVEL_BASIC, // Merge ticks, remove redundant jumps and unreachable or overwritten instructions.
+		LEVEL_FULL, // Also inline calls to small subroutines.
+	};
+
+	struct Stats {
+		uint32_t size_before = 0;
+		uint32_t size_after = 0;
+		uint32_t ticks_merged = 0;
+		uint32_t jumps_removed = 0;
+		uint32_t unreachable_removed = 0;
+		uint32_t overwritten_removed = 0;
+		uint32_t calls_inlined = 0;
+	};
+
+private:
+	static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+	static constexpr uint32_t PASS_COUNT_MAX = 16;
+
+	struct Instruction {
+		uint32_t offset = 0;
+		uint32_t size = 0;
+		uint8_t opcode = 0;
+		bool is_target = false; // Jumped to or entered from outside.
+		bool removed = false;
+		bool replaced = false; // Emit `replacement` instead.
+		uint32_t target = INVALID_INDEX; // Instruction index of jump target.
+		LocalVector<uint8_t> replacement;
+	};
+
+	LocalVector<uint8_t> code;
+	LocalVector<uint32_t> entries;
+	LocalVector<uint32_t> entry_indices;
+	LocalVector<Instruction> instructions;
+	bool has_delays = false;
+	Stats stats;
+
+	uint32_t find_instruction(uint32_t p_offset) const;
+	bool decode();
+	void emit();
+
+	bool merge_ticks();
+	bool remove_redundant_jumps();
+	bool remove_unreachable();
+	bool remove_overwritten();
+	bool inline_calls();
+
+public:
+	void set_code(const uint8_t *p_code, uint32_t p_size);
+	// Adds the offset of an instruction which is entered from outside, like a public label.
+	void add_entry(uint32_t p_offset);
+
+	// Returns `false` if the code could not be decoded. The code is not changed in this case.
+	bool optimize(Level p_level);
+
+	_ALWAYS_INLINE_ const LocalVector<uint8_t> &get_code() const { return code; }
+	_ALWAYS_INLINE_ uint32_t get_entry(uint32_t p_index) const { return entries[p_index]; }
+	_ALWAYS_INLINE_ const Stats &get_stats() const { return stats; }
+};
+
+} // namespace BlipKit
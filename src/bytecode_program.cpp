@@ -0,0 +1,190 @@
+#include "bytecode_program.hpp"
+#include <algorithm>
+
+using namespace BlipKit;
+using namespace godot;
+
+typedef BytecodeProgram::Opcode Opcode;
+
+uint32_t BytecodeProgram::get_argument_size(uint8_t p_opcode) {
+	switch (p_opcode) {
+		case Opcode::OP_NOOP:
+		case Opcode::OP_HALT:
+		case Opcode::OP_RELEASE:
+		case Opcode::OP_MUTE:
+		case Opcode::OP_RETURN:
+		case Opcode::OP_RESET: {
+			return 0;
+		} break;
+		case Opcode::OP_WAVEFORM:
+		case Opcode::OP_DUTY_CYCLE:
+		case Opcode::OP_PHASE_WRAP:
+		case Opcode::OP_INSTRUMENT:
+		case Opcode::OP_CUSTOM_WAVEFORM:
+		case Opcode::OP_SAMPLE:
+		case Opcode::OP_ARPEGGIO: { // Followed by values.
+			return sizeof(uint8_t);
+		} break;
+		case Opcode::OP_EFFECT_DIV:
+		case Opcode::OP_ARPEGGIO_DIV:
+		case Opcode::OP_INSTRUMENT_DIV:
+		case Opcode::OP_TICK:
+		case Opcode::OP_STEP:
+		case Opcode::OP_STEP_TICKS:
+		case Opcode::OP_DELAY_TICK:
+		case Opcode::OP_ATTACK:
+		case Opcode::OP_VOLUME:
+		case Opcode::OP_MASTER_VOLUME:
+		case Opcode::OP_PANNING:
+		case Opcode::OP_PITCH:
+		case Opcode::OP_PORTAMENTO:
+		case Opcode::OP_VOLUME_SLIDE:
+		case Opcode::OP_PANNING_SLIDE:
+		case Opcode::OP_DELAY_STEP:
+		case Opcode::OP_SAMPLE_PITCH: {
+			return sizeof(uint16_t);
+		} break;
+		case Opcode::OP_VIBRATO:
+		case Opcode::OP_TREMOLO: {
+			return sizeof(uint16_t) * 3;
+		} break;
+		case Opcode::OP_JUMP:
+		case Opcode::OP_CALL: {
+			return sizeof(int32_t);
+		} break;
+		default: {
+			return 0;
+		} break;
+	}
+}
+
+void BytecodeProgram::decode(ByteStreamReader &p_reader, uint32_t p_code_offset, uint32_t p_code_size) {
+	const uint32_t code_end = p_code_offset + p_code_size;
+	LocalVector<int32_t> jump_offsets;
+
+	clear();
+	code_offset = p_code_offset;
+	p_reader.seek(p_code_offset);
+
+	while (p_reader.get_position() < code_end) {
+		Instruction instruction;
+		instruction.code_offset = p_reader.get_position();
+		instruction.opcode = p_reader.get_u8();
+
+		if (instruction.opcode >= Opcode::OP_MAX) [[unlikely]] {
+			instruction.arg_u16 = instruction.opcode;
+			instruction.opcode = OP_FAIL;
+			instruction.arg_u8 = FAIL_INVALID_OPCODE;
+			instructions.push_back(instruction);
+			break;
+		}
+
+		uint32_t argument_size = get_argument_size(instruction.opcode);
+
+		if (instruction.opcode == Opcode::OP_ARPEGGIO && p_reader.get_position() < code_end) {
+			argument_size += p_reader.ptr()[p_reader.get_position()] * sizeof(uint16_t);
+		}
+
+		if (p_reader.get_position() + argument_size > code_end) [[unlikely]] {
+			instruction.opcode = OP_FAIL;
+			instruction.arg_u8 = FAIL_TRUNCATED;
+			instructions.push_back(instruction);
+			break;
+		}
+
+		switch (instruction.opcode) {
+			case Opcode::OP_WAVEFORM:
+			case Opcode::OP_DUTY_CYCLE:
+			case Opcode::OP_PHASE_WRAP:
+			case Opcode::OP_INSTRUMENT:
+			case Opcode::OP_CUSTOM_WAVEFORM:
+			case Opcode::OP_SAMPLE: {
+				instruction.arg_u8 = p_reader.get_u8();
+			} break;
+			case Opcode::OP_EFFECT_DIV:
+			case Opcode::OP_ARPEGGIO_DIV:
+			case Opcode::OP_INSTRUMENT_DIV:
+			case Opcode::OP_TICK:
+			case Opcode::OP_STEP:
+			case Opcode::OP_STEP_TICKS:
+			case Opcode::OP_DELAY_TICK: {
+				instruction.arg_u16 = p_reader.get_u16();
+			} break;
+			case Opcode::OP_ATTACK:
+			case Opcode::OP_VOLUME:
+			case Opcode::OP_MASTER_VOLUME:
+			case Opcode::OP_PANNING:
+			case Opcode::OP_PITCH:
+			case Opcode::OP_PORTAMENTO:
+			case Opcode::OP_VOLUME_SLIDE:
+			case Opcode::OP_PANNING_SLIDE:
+			case Opcode::OP_DELAY_STEP:
+			case Opcode::OP_SAMPLE_PITCH: {
+				instruction.args[0] = p_reader.get_f16();
+			} break;
+			case Opcode::OP_VIBRATO:
+			case Opcode::OP_TREMOLO: {
+				instruction.args[0] = p_reader.get_f16();
+				instruction.args[1] = p_reader.get_f16();
+				instruction.args[2] = p_reader.get_f16();
+			} break;
+			case Opcode::OP_ARPEGGIO: {
+				instruction.arg_u8 = p_reader.get_u8();
+				instruction.index = values.size();
+
+				for (uint32_t i = 0; i < instruction.arg_u8; i++) {
+					values.push_back(p_reader.get_f16());
+				}
+			} break;
+			case Opcode::OP_JUMP:
+			case Opcode::OP_CALL: {
+				// Relative to the position of the address.
+				const uint32_t address_position = p_reader.get_position() - p_code_offset;
+				const int32_t offset = p_reader.get_s32();
+
+				instruction.index = jump_offsets.size();
+				jump_offsets.push_back(int32_t(address_position) + offset);
+			} break;
+			default: {
+				// No arguments.
+			} break;
+		}
+
+		instructions.push_back(instruction);
+	}
+
+	// Allows falling through to the end without bounds checks.
+	Instruction end;
+	end.opcode = OP_END;
+	end.code_offset = code_end;
+	instructions.push_back(end);
+
+	// Resolve jump targets.
+	for (Instruction &instruction : instructions) {
+		if (instruction.opcode == Opcode::OP_JUMP || instruction.opcode == Opcode::OP_CALL) {
+			const int32_t position = jump_offsets[instruction.index];
+			instruction.index = position >= 0 ? find_instruction(position) : INVALID_INDEX;
+		}
+	}
+}
+
+void BytecodeProgram::clear() {
+	instructions.clear();
+	values.clear();
+	code_offset = 0;
+}
+
+uint32_t BytecodeProgram::find_instruction(uint32_t p_code_position) const {
+	const uint64_t offset = uint64_t(code_offset) + p_code_position;
+	const Instruction *begin = instructions.ptr();
+	const Instruction *end = begin + instructions.size();
+	const Instruction *instruction = std::lower_bound(begin, end, offset, [](const Instruction &p_instruction, uint64_t p_offset) {
+		return p_instruction.code_offset < p_offset;
+	});
+
+	if (instruction == end || instruction->code_offset != offset) {
+		return INVALID_INDEX;
+	}
+
+	return instruction - begin;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "blipkit_assembler.hpp"
+#include "byte_stream.hpp"
+#include <godot_cpp/templates/local_vector.hpp>
+
+using namespace godot;
+
+namespace BlipKit {
+
+// Byte code decoded into fixed-size instructions with expanded arguments and
+// resolved jump targets.
+class BytecodeProgram {
+public:
+	typedef BlipKitAssembler::Opcode Opcode;
+
+	// Pseudo opcodes following the byte code opcodes.
+	enum : uint8_t {
+		OP_END = Opcode::OP_MAX, // End of code section.
+		OP_FAIL, // Invalid or truncated instruction.
+		OP_COUNT,
+	};
+
+	enum Failure : uint8_t {
+		FAIL_INVALID_OPCODE,
+		FAIL_TRUNCATED,
+	};
+
+	static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+	struct Instruction {
+		uint8_t opcode = Opcode::OP_NOOP;
+		uint8_t arg_u8 = 0; // Also the failure or arpeggio value count.
+		uint16_t arg_u16 = 0; // Also the invalid opcode.
+		uint32_t index = 0; // Jump target or index of the first arpeggio value.
+		float args[3] = { 0.0, 0.0, 0.0 };
+		uint32_t code_offset = 0; // Byte offset in the binary.
+	};
+
+private:
+	LocalVector<Instruction> instructions;
+	LocalVector<float> values;
+	uint32_t code_offset = 0;
+
+public:
+	// Returns the size of the arguments following the opcode. `OP_ARPEGGIO`
+	// is followed by additional values.
+	static uint32_t get_argument_size(uint8_t p_opcode);
+
+	// Decodes `p_code_size` bytes from `p_code_offset`. Ends with `OP_END`.
+	void decode(ByteStreamReader &p_reader, uint32_t p_code_offset, uint32_t p_code_size);
+	void clear();
+
+	// Returns the index of the instruction at the position relative to the code
+	// section, or `INVALID_INDEX` if no instruction starts at this position.
+	uint32_t find_instruction(uint32_t p_code_position) const;
+
+	_ALWAYS_INLINE_ const Instruction *get_instructions() const { return instructions.ptr(); }
+	_ALWAYS_INLINE_ uint32_t get_instruction_count() const { return instructions.size(); }
+	_ALWAYS_INLINE_ const float *get_values() const { return values.ptr(); }
+};
+
+} // namespace BlipKit
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <godot_cpp/core/defs.hpp>
+
+namespace BlipKit {
+
+// A bounded lock-free queue which allows multiple producers and a single consumer.
+// Based on Dmitry Vyukov's bounded MPMC queue.
+template <typename T, uint32_t SIZE>
+class CommandQueue {
+	static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "Size must be a power of 2.");
+
+private:
+	static constexpr uint32_t MASK = SIZE - 1;
+	static constexpr uint32_t CACHE_LINE_SIZE = 64;
+
+	struct Cell {
+		std::atomic<uint32_t> sequence;
+		T value;
+	};
+
+	Cell cells[SIZE];
+	alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> head = 0;
+	alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> tail = 0;
+
+public:
+	CommandQueue() {
+		for (uint32_t i = 0; i < SIZE; i++) {
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	// Returns `false` if the queue is full.
+	_ALWAYS_INLINE_ bool push(const T &p_value) {
+		uint32_t position = head.load(std::memory_order_relaxed);
+
+		while (true) {
+			Cell &cell = cells[position & MASK];
+			const uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+			const int32_t diff = int32_t(sequence - position);
+
+			if (diff == 0) {
+				if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					cell.value = p_value;
+					cell.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (diff < 0) [[unlikely]] {
+				return false;
+			} else {
+				position = head.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// Pushes all values or none. The consumer does not pop any of the values
+	// before all of them are pushed. Returns `false` if the queue has not
+	// enough free cells.
+	bool push_batch(const T *p_values, uint32_t p_count) {
+		if (p_count == 0) {
+			return true;
+		}
+
+		if (p_count > SIZE) {
+			return false;
+		}
+
+		uint32_t position = head.load(std::memory_order_relaxed);
+
+		while (true) {
+			// Cells are freed in order, so all cells are free if the last one is.
+			const uint32_t last = position + p_count - 1;
+			const uint32_t sequence = cells[last & MASK].sequence.load(std::memory_order_acquire);
+			const int32_t diff = int32_t(sequence - last);
+
+			if (diff == 0) {
+				if (head.compare_exchange_weak(position, position + p_count, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (diff < 0) {
+				return false;
+			} else {
+				position = head.load(std::memory_order_relaxed);
+			}
+		}
+
+		for (uint32_t i = 0; i < p_count; i++) {
+			cells[(position + i) & MASK].value = p_values[i];
+		}
+
+		// Publish the first cell last, as the consumer stops at the first
+		// unpublished cell.
+		for (uint32_t i = p_count; i > 0; i--) {
+			cells[(position + i - 1) & MASK].sequence.store(position + i, std::memory_order_release);
+		}
+
+		return true;
+	}
+
+	// Returns `false` if the queue is empty.
+	// Must not be called from multiple threads at the same time.
+	_ALWAYS_INLINE_ bool pop(T &r_value) {
+		const uint32_t position = tail.load(std::memory_order_relaxed);
+		Cell &cell = cells[position & MASK];
+		const uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+		if (sequence != position + 1) {
+			return false;
+		}
+
+		r_value = cell.value;
+		cell.sequence.store(position + SIZE, std::memory_order_release);
+		tail.store(position + 1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	_ALWAYS_INLINE_ bool is_empty() const {
+		const uint32_t position = tail.load(std::memory_order_relaxed);
+		const uint32_t sequence = cells[position & MASK].sequence.load(std::memory_order_acquire);
+
+		return sequence != position + 1;
+	}
+};
+
+} // namespace BlipKit
@@ -1,47 +1,69 @@
 #include "divider.hpp"
 #include "audio_stream_blipkit.hpp"
+#include "blipkit_track.hpp"
+#include <algorithm>
 
 using namespace BlipKit;
 using namespace godot;
 
 std::atomic<DividerGroup::ID> DividerGroup::id = 0;
 
-void DividerGroup::Divider::initialize(const Callable &p_callable, int p_tick_interval) {
-	callable = p_callable;
-	divider = p_tick_interval;
-}
-
-void DividerGroup::Divider::reset(int p_tick_interval) {
-	if (p_tick_interval > 0) {
-		divider = p_tick_interval;
-	}
-	counter = 0;
-}
-
 BKEnum DividerGroup::divider_callback(BKCallbackInfo *p_info, void *p_user_info) {
 	DividerGroup *group = static_cast<DividerGroup *>(p_user_info);
-	HashMap<ID, Divider> &dividers = group->dividers;
-	thread_local LocalVector<ID> removed_dividers;
-	removed_dividers.clear();
+	LocalVector<Entry> &queue = group->queue;
+	const uint64_t tick = ++group->tick;
 
-	for (KeyValue<ID, Divider> &E : dividers) {
-		Divider &divider = E.value;
-		int ticks = divider.tick();
+	group->is_ticking = true;
+
+	while (not queue.is_empty() && queue[0].tick <= tick) {
+		std::pop_heap(queue.ptr(), queue.ptr() + queue.size(), Entry::is_later);
+		const Entry entry = queue[queue.size() - 1];
+		queue.remove_at(queue.size() - 1);
+
+		Divider *divider = group->dividers.getptr(entry.id);
+
+		// Divider was removed or reset.
+		if (not divider || divider->generation != entry.generation) {
+			continue;
+		}
+
+		const int ticks = group->call_divider(*divider);
+
+		// The callable may have changed the dividers.
+		divider = group->dividers.getptr(entry.id);
+
+		if (not divider || divider->generation != entry.generation) {
+			continue;
+		}
 
 		// Remove divider.
 		if (ticks < 0) {
-			removed_dividers.push_back(E.key);
+			group->dividers.erase(entry.id);
+
+			if (group->dividers.is_empty()) {
+				group->update_attached();
+			}
+
+			continue;
+		}
+
+		// Set new divider value.
+		if (ticks > 0) {
+			divider->divider = ticks;
 		}
-	}
 
-	for (const ID &id : removed_dividers) {
-		dividers.erase(id);
+		divider->next_tick = tick + divider->divider;
+		group->push_entry(entry.id, *divider);
 	}
 
+	group->is_ticking = false;
+	group->compact();
+
 	return BK_SUCCESS;
 }
 
-DividerGroup::DividerGroup() {
+DividerGroup::DividerGroup(BlipKitTrack *p_track) :
+		track(p_track) {
 	BKCallback callback = {
 		.func = divider_callback,
 		.userInfo = static_cast<void *>(this),
@@ -53,6 +75,74 @@ DividerGroup::~DividerGroup() {
 	detach();
 }
 
+int DividerGroup::call_divider(Divider &p_divider) {
+	switch (p_divider.type) {
+		case TYPE_CALLABLE: {
+			// The callable may add or remove dividers, which invalidates
+			// `p_divider`. Keep the callable alive while it is called.
+			const Callable callable = p_divider.callable;
+
+			return callable.call();
+		} break;
+		case TYPE_INTERPRETER: {
+			// Interpreters do not change dividers.
+			const int ticks = p_divider.interpreter->advance_track(track);
+
+			// Remove divider when finished or failed.
+			return ticks > 0 ? ticks : -1;
+		} break;
+		case TYPE_PATTERN: {
+			const float note = p_divider.notes[p_divider.note_index];
+			p_divider.note_index = (p_divider.note_index + 1) % p_divider.notes.size();
+			track->set_note(note);
+
+			return 0;
+		} break;
+	}
+
+	return -1;
+}
+
+void DividerGroup::push_entry(ID p_id, const Divider &p_divider) {
+	queue.push_back({ p_divider.next_tick, p_id, p_divider.generation });
+	std::push_heap(queue.ptr(), queue.ptr() + queue.size(), Entry::is_later);
+}
+
+void DividerGroup::compact() {
+	// Only rebuild when most entries are stale. Entries of called dividers
+	// are not queued again until they return.
+	if (is_ticking || queue.size() <= dividers.size() * 2 + 16) {
+		return;
+	}
+
+	queue.clear();
+
+	for (const KeyValue<ID, Divider> &E : dividers) {
+		queue.push_back({ E.value.next_tick, E.key, E.value.generation });
+	}
+
+	std::make_heap(queue.ptr(), queue.ptr() + queue.size(), Entry::is_later);
+}
+
+void DividerGroup::update_attached() {
+	const bool has_dividers = not dividers.is_empty();
+
+	if (not playback || has_dividers == is_attached) {
+		return;
+	}
+
+	is_attached = has_dividers;
+
+	if (is_attached) {
+		playback->attach_divider(&divider);
+	} else if (is_ticking) {
+		// Dividers cannot be detached while the clock is ticking.
+		playback->detach_divider_deferred(&divider);
+	} else {
+		playback->detach_divider(&divider);
+	}
+}
+
 PackedInt32Array DividerGroup::get_dividers() const {
 	PackedInt32Array ids;
 	ids.resize(dividers.size());
@@ -65,16 +155,58 @@ PackedInt32Array DividerGroup::get_dividers() const {
 	return ids;
 }
 
-DividerGroup::ID DividerGroup::add_divider(int p_tick_interval, const Callable &p_callable) {
+DividerGroup::ID DividerGroup::add(Divider &&p_divider) {
 	ID new_id = ++id;
 	Divider &divider = dividers[new_id];
-	divider.initialize(p_callable, p_tick_interval);
+	divider = std::move(p_divider);
+	// Called for the first time on the next tick.
+	divider.next_tick = tick + 1;
+	push_entry(new_id, divider);
+
+	if (dividers.size() == 1) {
+		update_attached();
+	}
 
 	return new_id;
 }
 
+DividerGroup::ID DividerGroup::add_divider(int p_tick_interval, const Callable &p_callable) {
+	Divider divider;
+	divider.type = TYPE_CALLABLE;
+	divider.callable = p_callable;
+	divider.divider = p_tick_interval;
+
+	return add(std::move(divider));
+}
+
+DividerGroup::ID DividerGroup::add_interpreter_divider(const Ref<BlipKitInterpreter> &p_interpreter) {
+	Divider divider;
+	divider.type = TYPE_INTERPRETER;
+	divider.interpreter = p_interpreter;
+	divider.divider = 1; // Replaced by the ticks returned by the interpreter.
+
+	return add(std::move(divider));
+}
+
+DividerGroup::ID DividerGroup::add_pattern_divider(int p_tick_interval, const PackedFloat32Array &p_notes) {
+	Divider divider;
+	divider.type = TYPE_PATTERN;
+	divider.notes = p_notes;
+	divider.divider = p_tick_interval;
+
+	return add(std::move(divider));
+}
+
 void DividerGroup::remove_divider(ID p_id) {
-	dividers.erase(p_id);
+	if (not dividers.erase(p_id)) {
+		return;
+	}
+
+	compact();
+
+	if (dividers.is_empty()) {
+		update_attached();
+	}
 }
 
 bool DividerGroup::has_divider(ID p_id) {
@@ -82,32 +214,54 @@ bool DividerGroup::has_divider(ID p_id) {
 }
 
 void DividerGroup::reset_divider(ID p_id, int p_tick_interval) {
-	ERR_FAIL_COND(not has_divider(p_id));
+	Divider *divider = dividers.getptr(p_id);
+	ERR_FAIL_NULL(divider);
 
-	dividers[p_id].reset(p_tick_interval);
+	if (p_tick_interval > 0) {
+		divider->divider = p_tick_interval;
+	}
+
+	divider->next_tick = tick + 1;
+	divider->generation++;
+	push_entry(p_id, *divider);
+	compact();
 }
 
 void DividerGroup::attach(AudioStreamBlipKitPlayback *p_playback) {
 	ERR_FAIL_NULL(p_playback);
 
-	BKContext *context = p_playback->get_context();
-
-	BKContextAttachDivider(context, &divider, BK_CLOCK_TYPE_BEAT);
+	playback = p_playback;
+	is_attached = false;
+	update_attached();
 }
 
 void DividerGroup::detach() {
-	BK_THREAD_SAFE_METHOD
+	if (not playback) {
+		return;
+	}
+
+	MutexLock playback_lock = playback->mutex_lock();
 
-	BKDividerDetach(&divider);
+	playback->detach_divider(&divider);
+	playback = nullptr;
+	is_attached = false;
 }
 
 void DividerGroup::reset() {
+	queue.clear();
+
 	for (KeyValue<ID, Divider> &E : dividers) {
 		Divider &divider = E.value;
-		divider.reset();
+		divider.next_tick = tick + 1;
+		divider.generation++;
+		queue.push_back({ divider.next_tick, E.key, divider.generation });
 	}
+
+	std::make_heap(queue.ptr(), queue.ptr() + queue.size(), Entry::is_later);
 }
 
 void DividerGroup::clear() {
 	dividers.clear();
+	queue.clear();
+	update_attached();
 }
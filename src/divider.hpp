@@ -1,9 +1,12 @@
 #pragma once
 
+#include "blipkit_interpreter.hpp"
 #include <BlipKit.h>
 #include <atomic>
 #include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 #include <godot_cpp/variant/callable.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
 #include <godot_cpp/variant/packed_int32_array.hpp>
 #include <godot_cpp/variant/string.hpp>
 
@@ -12,53 +15,73 @@ using namespace godot;
 namespace BlipKit {
 
 class AudioStreamBlipKitPlayback;
+class BlipKitTrack;
 
 class DividerGroup {
 public:
 	typedef uint32_t ID;
 
 private:
-	class Divider {
-	private:
+	enum Type : uint8_t {
+		TYPE_CALLABLE,
+		TYPE_INTERPRETER, // Advances an interpreter without calling into scripts.
+		TYPE_PATTERN, // Plays the next note of a pattern.
+	};
+
+	struct Divider {
+		Type type = TYPE_CALLABLE;
 		Callable callable;
+		Ref<BlipKitInterpreter> interpreter;
+		PackedFloat32Array notes;
+		uint32_t note_index = 0;
 		int divider = 0;
-		int counter = 0;
-
-	public:
-		void initialize(const Callable &p_callable, int p_tick_interval);
-		void reset(int p_tick_interval = 0);
-
-		_ALWAYS_INLINE_ int tick() {
-			counter--;
-
-			if (counter > 0) [[likely]] {
-				return 0;
-			} else {
-				int ticks = callable.call();
+		uint64_t next_tick = 0;
+		uint32_t generation = 0; // Invalidates queued entries when reset.
+	};
 
-				// Set new divider value.
-				if (ticks > 0) {
-					divider = ticks;
-				}
-				counter = divider;
+	// Queued tick of a divider. Entries of removed or reset dividers are
+	// skipped when they are reached.
+	struct Entry {
+		uint64_t tick = 0;
+		ID id = 0;
+		uint32_t generation = 0;
 
-				return ticks;
-			}
+		// Orders the heap by the next tick; dividers added first are called first.
+		_ALWAYS_INLINE_ static bool is_later(const Entry &p_a, const Entry &p_b) {
+			return p_a.tick != p_b.tick ? p_a.tick > p_b.tick : p_a.id > p_b.id;
 		}
 	};
 
 	static std::atomic<ID> id;
 	HashMap<ID, Divider> dividers;
+	LocalVector<Entry> queue; // Min-heap.
+	uint64_t tick = 0;
+	bool is_ticking = false;
+	bool is_attached = false; // `divider` is attached to `playback`.
 	BKDivider divider = { { 0 } };
+	BlipKitTrack *track = nullptr;
+	AudioStreamBlipKitPlayback *playback = nullptr;
+
+	ID add(Divider &&p_divider);
+	// `p_divider` must not be used after calling as the dividers may have changed.
+	int call_divider(Divider &p_divider);
+	void push_entry(ID p_id, const Divider &p_divider);
+	void compact();
+	// Attaches `divider` only while there are dividers to call, so that empty
+	// groups do not keep the playback from skipping silent frames. Has to be
+	// called when `dividers` becomes empty or non-empty.
+	void update_attached();
 
 	static BKEnum divider_callback(BKCallbackInfo *p_info, void *p_user_info);
 
 public:
-	DividerGroup();
+	DividerGroup(BlipKitTrack *p_track);
 	~DividerGroup();
 
 	PackedInt32Array get_dividers() const;
 	ID add_divider(int p_tick_interval, const Callable &p_callable);
+	ID add_interpreter_divider(const Ref<BlipKitInterpreter> &p_interpreter);
+	ID add_pattern_divider(int p_tick_interval, const PackedFloat32Array &p_notes);
 	void remove_divider(ID p_id);
 	bool has_divider(ID p_id);
 	void reset_divider(ID p_id, int p_tick_interval = 0);
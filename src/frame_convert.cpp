@@ -0,0 +1,138 @@
+#include "frame_convert.hpp"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BK_FRAME_CONVERT_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define BK_FRAME_CONVERT_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define BK_FRAME_CONVERT_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace BlipKit;
+
+static constexpr float FRAME_SCALE = 1.0 / float(BK_FRAME_MAX);
+
+// Values are copied with `memcpy`, as source and destination may overlap.
+static void convert_frames_scalar(const BKFrame *p_src, float *p_dst, uint32_t p_count) {
+	for (uint32_t i = 0; i < p_count; i++) {
+		BKFrame value;
+		memcpy(&value, &p_src[i], sizeof(value));
+		const float result = float(value) * FRAME_SCALE;
+		memcpy(&p_dst[i], &result, sizeof(result));
+	}
+}
+
+#ifdef BK_FRAME_CONVERT_SSE2
+
+static void convert_frames_sse2(const BKFrame *p_src, float *p_dst, uint32_t p_count) {
+	const __m128 scale = _mm_set1_ps(FRAME_SCALE);
+	uint32_t i = 0;
+
+	for (; i + 8 <= p_count; i += 8) {
+		const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&p_src[i]));
+
+		// Sign-extend to 32 bit.
+		const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+		const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+
+		_mm_storeu_ps(&p_dst[i + 0], _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+		_mm_storeu_ps(&p_dst[i + 4], _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+	}
+
+	convert_frames_scalar(&p_src[i], &p_dst[i], p_count - i);
+}
+
+#endif // BK_FRAME_CONVERT_SSE2
+
+#ifdef BK_FRAME_CONVERT_AVX2
+
+__attribute__((target("avx2"))) static void convert_frames_avx2(const BKFrame *p_src, float *p_dst, uint32_t p_count) {
+	const __m256 scale = _mm256_set1_ps(FRAME_SCALE);
+	uint32_t i = 0;
+
+	for (; i + 16 <= p_count; i += 16) {
+		// Load all values before storing.
+		const __m128i values_low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&p_src[i + 0]));
+		const __m128i values_high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&p_src[i + 8]));
+
+		const __m256 low = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(values_low));
+		const __m256 high = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(values_high));
+
+		_mm256_storeu_ps(&p_dst[i + 0], _mm256_mul_ps(low, scale));
+		_mm256_storeu_ps(&p_dst[i + 8], _mm256_mul_ps(high, scale));
+	}
+
+	convert_frames_sse2(&p_src[i], &p_dst[i], p_count - i);
+}
+
+#endif // BK_FRAME_CONVERT_AVX2
+
+#ifdef BK_FRAME_CONVERT_NEON
+
+static void convert_frames_neon(const BKFrame *p_src, float *p_dst, uint32_t p_count) {
+	uint32_t i = 0;
+
+	for (; i + 8 <= p_count; i += 8) {
+		const int16x8_t values = vld1q_s16(&p_src[i]);
+
+		const float32x4_t low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(values)));
+		const float32x4_t high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(values)));
+
+		vst1q_f32(&p_dst[i + 0], vmulq_n_f32(low, FRAME_SCALE));
+		vst1q_f32(&p_dst[i + 4], vmulq_n_f32(high, FRAME_SCALE));
+	}
+
+	convert_frames_scalar(&p_src[i], &p_dst[i], p_count - i);
+}
+
+#endif // BK_FRAME_CONVERT_NEON
+
+static const FrameConverter converters[] = {
+	{ "scalar", convert_frames_scalar },
+#ifdef BK_FRAME_CONVERT_SSE2
+	{ "sse2", convert_frames_sse2 },
+#endif
+#ifdef BK_FRAME_CONVERT_AVX2
+	{ "avx2", convert_frames_avx2 },
+#endif
+#ifdef BK_FRAME_CONVERT_NEON
+	{ "neon", convert_frames_neon },
+#endif
+};
+
+static uint32_t get_supported_count() {
+	uint32_t count = sizeof(converters) / sizeof(converters[0]);
+
+#ifdef BK_FRAME_CONVERT_AVX2
+	// AVX2 is the last entry; check if the CPU supports it.
+	__builtin_cpu_init();
+
+	if (not __builtin_cpu_supports("avx2")) {
+		count--;
+	}
+#endif
+
+	return count;
+}
+
+static const uint32_t supported_count = get_supported_count();
+static const FrameConverter &selected_converter = converters[supported_count - 1];
+
+void BlipKit::convert_frames(const BKFrame *p_src, float *p_dst, uint32_t p_count) {
+	selected_converter.convert(p_src, p_dst, p_count);
+}
+
+const FrameConverter &BlipKit::get_frame_converter() {
+	return selected_converter;
+}
+
+uint32_t BlipKit::get_frame_converters(const FrameConverter **r_converters) {
+	*r_converters = converters;
+
+	return supported_count;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <BlipKit.h>
+#include <cstdint>
+
+namespace BlipKit {
+
+typedef void (*FrameConvertFunc)(const BKFrame *p_src, float *p_dst, uint32_t p_count);
+
+struct FrameConverter {
+	const char *name = nullptr;
+	FrameConvertFunc convert = nullptr;
+};
+
+// Converts `p_count` interleaved frame values to floats in the range [-1.0, +1.0].
+// The conversion can be done in place if `p_src` starts at least `p_count * sizeof(BKFrame)`
+// bytes after `p_dst`, e.g., in the upper half of the destination buffer.
+void convert_frames(const BKFrame *p_src, float *p_dst, uint32_t p_count);
+
+// Returns the converter selected for the current CPU.
+const FrameConverter &get_frame_converter();
+
+// Returns all converters supported by the current CPU; the last one is the selected one.
+uint32_t get_frame_converters(const FrameConverter **r_converters);
+
+} // namespace BlipKit
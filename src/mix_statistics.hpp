@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <godot_cpp/core/defs.hpp>
+
+namespace BlipKit {
+
+// Statistics of mix calls. Written by the audio thread and read from any thread.
+class MixStatistics {
+private:
+	// Histogram buckets of mix times in microseconds: 0-7 are exact,
+	// followed by 4 buckets per power of 2.
+	static constexpr uint32_t HISTOGRAM_SIZE = 64;
+
+	std::atomic<uint64_t> mix_count = 0;
+	std::atomic<uint64_t> mix_time_sum = 0;
+	std::atomic<uint64_t> mix_time_min = UINT64_MAX;
+	std::atomic<uint64_t> mix_time_max = 0;
+	std::atomic<uint64_t> lock_wait_sum = 0;
+	std::atomic<uint64_t> lock_wait_max = 0;
+	std::atomic<uint64_t> frames_generated = 0;
+	std::atomic<uint64_t> frames_zero_filled = 0;
+	std::atomic<uint64_t> sync_calls = 0;
+	std::atomic<uint32_t> histogram[HISTOGRAM_SIZE] = {};
+
+	static uint32_t get_bucket(uint64_t p_usec) {
+		if (p_usec < 8) {
+			return p_usec;
+		}
+
+		uint32_t msb = 0;
+		for (uint64_t value = p_usec; value > 1; value >>= 1) {
+			msb++;
+		}
+
+		const uint32_t sub_bucket = (p_usec >> (msb - 2)) & 3;
+
+		return MIN(8 + (msb - 3) * 4 + sub_bucket, HISTOGRAM_SIZE - 1);
+	}
+
+	static uint64_t get_bucket_start(uint32_t p_bucket) {
+		if (p_bucket < 8) {
+			return p_bucket;
+		}
+
+		const uint32_t msb = 3 + (p_bucket - 8) / 4;
+		const uint32_t sub_bucket = (p_bucket - 8) % 4;
+
+		return uint64_t(4 + sub_bucket) << (msb - 2);
+	}
+
+	// Only called by a single writer.
+	_ALWAYS_INLINE_ static void add(std::atomic<uint64_t> &r_value, uint64_t p_value) {
+		r_value.store(r_value.load(std::memory_order_relaxed) + p_value, std::memory_order_relaxed);
+	}
+
+	_ALWAYS_INLINE_ static void update_max(std::atomic<uint64_t> &r_value, uint64_t p_value) {
+		if (p_value > r_value.load(std::memory_order_relaxed)) {
+			r_value.store(p_value, std::memory_order_relaxed);
+		}
+	}
+
+public:
+	// Records a mix call. Times are in nanoseconds.
+	void record_mix(uint64_t p_mix_time, uint64_t p_lock_wait, uint32_t p_generated, uint32_t p_zero_filled, uint32_t p_sync_calls) {
+		add(mix_count, 1);
+		add(mix_time_sum, p_mix_time);
+		add(lock_wait_sum, p_lock_wait);
+		add(frames_generated, p_generated);
+		add(frames_zero_filled, p_zero_filled);
+		add(sync_calls, p_sync_calls);
+
+		update_max(mix_time_max, p_mix_time);
+		update_max(lock_wait_max, p_lock_wait);
+
+		if (p_mix_time < mix_time_min.load(std::memory_order_relaxed)) {
+			mix_time_min.store(p_mix_time, std::memory_order_relaxed);
+		}
+
+		histogram[get_bucket(p_mix_time / 1000)].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void reset() {
+		mix_count.store(0, std::memory_order_relaxed);
+		mix_time_sum.store(0, std::memory_order_relaxed);
+		mix_time_min.store(UINT64_MAX, std::memory_order_relaxed);
+		mix_time_max.store(0, std::memory_order_relaxed);
+		lock_wait_sum.store(0, std::memory_order_relaxed);
+		lock_wait_max.store(0, std::memory_order_relaxed);
+		frames_generated.store(0, std::memory_order_relaxed);
+		frames_zero_filled.store(0, std::memory_order_relaxed);
+		sync_calls.store(0, std::memory_order_relaxed);
+
+		for (std::atomic<uint32_t> &count : histogram) {
+			count.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	_ALWAYS_INLINE_ uint64_t get_mix_count() const { return mix_count.load(std::memory_order_relaxed); }
+	_ALWAYS_INLINE_ uint64_t get_frames_generated() const { return frames_generated.load(std::memory_order_relaxed); }
+	_ALWAYS_INLINE_ uint64_t get_frames_zero_filled() const { return frames_zero_filled.load(std::memory_order_relaxed); }
+	_ALWAYS_INLINE_ uint64_t get_sync_calls() const { return sync_calls.load(std::memory_order_relaxed); }
+
+	// Times are returned in microseconds.
+	double get_mix_time_min() const {
+		const uint64_t value = mix_time_min.load(std::memory_order_relaxed);
+		return value == UINT64_MAX ? 0.0 : double(value) * 1e-3;
+	}
+
+	double get_mix_time_avg() const {
+		const uint64_t count = get_mix_count();
+		return count ? double(mix_time_sum.load(std::memory_order_relaxed)) * 1e-3 / double(count) : 0.0;
+	}
+
+	double get_mix_time_max() const {
+		return double(mix_time_max.load(std::memory_order_relaxed)) * 1e-3;
+	}
+
+	// Returns the upper bound of the histogram bucket containing the 99th percentile.
+	double get_mix_time_p99() const {
+		uint64_t total = 0;
+		for (const std::atomic<uint32_t> &count : histogram) {
+			total += count.load(std::memory_order_relaxed);
+		}
+
+		if (total == 0) {
+			return 0.0;
+		}
+
+		const uint64_t target = total - total / 100;
+		uint64_t sum = 0;
+
+		for (uint32_t i = 0; i < HISTOGRAM_SIZE - 1; i++) {
+			sum += histogram[i].load(std::memory_order_relaxed);
+
+			if (sum >= target) {
+				return double(get_bucket_start(i + 1));
+			}
+		}
+
+		return get_mix_time_max();
+	}
+
+	double get_lock_wait_avg() const {
+		const uint64_t count = get_mix_count();
+		return count ? double(lock_wait_sum.load(std::memory_order_relaxed)) * 1e-3 / double(count) : 0.0;
+	}
+
+	double get_lock_wait_max() const {
+		return double(lock_wait_max.load(std::memory_order_relaxed)) * 1e-3;
+	}
+};
+
+} // namespace BlipKit
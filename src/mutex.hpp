@@ -1,6 +1,10 @@
 #pragma once
 
 #include <godot_cpp/core/defs.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
 #include <mutex>
 
 namespace BlipKit {
@@ -14,9 +18,47 @@ public:
 		mutex.lock();
 	}
 
+	_ALWAYS_INLINE_ bool try_lock() {
+		return mutex.try_lock();
+	}
+
+	_ALWAYS_INLINE_ void unlock() {
+		mutex.unlock();
+	}
+};
+
+// Counts the locks held by the current thread, so that it can avoid blocking
+// on another mutex of this type in an inconsistent order.
+class CountedRecursiveMutex {
+private:
+	static inline thread_local uint32_t thread_lock_count = 0;
+
+	std::recursive_mutex mutex;
+
+public:
+	_ALWAYS_INLINE_ void lock() {
+		mutex.lock();
+		thread_lock_count++;
+	}
+
+	_ALWAYS_INLINE_ bool try_lock() {
+		if (not mutex.try_lock()) {
+			return false;
+		}
+
+		thread_lock_count++;
+
+		return true;
+	}
+
 	_ALWAYS_INLINE_ void unlock() {
+		thread_lock_count--;
 		mutex.unlock();
 	}
+
+	_ALWAYS_INLINE_ static uint32_t get_thread_lock_count() {
+		return thread_lock_count;
+	}
 };
 
 template <typename MutexT>
@@ -35,4 +77,34 @@ public:
 	}
 };
 
+// Locks up to `N` mutexes in address order, so that threads locking
+// overlapping sets do not deadlock. Null and duplicate mutexes are skipped.
+template <typename MutexT, uint32_t N>
+class OrderedMutexLock {
+private:
+	MutexT *mutexes[N] = {};
+	uint32_t count = 0;
+
+public:
+	OrderedMutexLock(std::initializer_list<MutexT *> p_mutexes) {
+		for (MutexT *mutex : p_mutexes) {
+			if (mutex && count < N && std::find(mutexes, mutexes + count, mutex) == mutexes + count) {
+				mutexes[count++] = mutex;
+			}
+		}
+
+		std::sort(mutexes, mutexes + count, std::less<MutexT *>());
+
+		for (uint32_t i = 0; i < count; i++) {
+			mutexes[i]->lock();
+		}
+	}
+
+	~OrderedMutexLock() {
+		for (uint32_t i = count; i > 0; i--) {
+			mutexes[i - 1]->unlock();
+		}
+	}
+};
+
 } //namespace BlipKit
@@ -1,10 +1,14 @@
 #include "audio_stream_blipkit.hpp"
 #include "blipkit_assembler.hpp"
+#include "blipkit_batch_renderer.hpp"
 #include "blipkit_bytecode.hpp"
 #include "blipkit_instrument.hpp"
 #include "blipkit_interpreter.hpp"
 #include "blipkit_sample.hpp"
+#include "blipkit_sequencer.hpp"
+#include "blipkit_slot_bank.hpp"
 #include "blipkit_track.hpp"
+#include "blipkit_voice_pool.hpp"
 #include "blipkit_waveform.hpp"
 #include "string_names.hpp"
 #include <gdextension_interface.h>
@@ -26,13 +30,17 @@ static void initialize_module(ModuleInitializationLevel p_level) {
 	GDREGISTER_CLASS(AudioStreamBlipKit);
 	GDREGISTER_CLASS(AudioStreamBlipKitPlayback);
 	GDREGISTER_CLASS(BlipKitAssembler);
+	GDREGISTER_CLASS(BlipKitBatchRenderer);
 	GDREGISTER_CLASS(BlipKitBytecode);
 	GDREGISTER_CLASS(BlipKitBytecodeLoader);
 	GDREGISTER_CLASS(BlipKitBytecodeSaver);
 	GDREGISTER_CLASS(BlipKitInstrument);
 	GDREGISTER_CLASS(BlipKitInterpreter);
 	GDREGISTER_CLASS(BlipKitSample);
+	GDREGISTER_CLASS(BlipKitSequencer);
+	GDREGISTER_CLASS(BlipKitSlotBank);
 	GDREGISTER_CLASS(BlipKitTrack);
+	GDREGISTER_CLASS(BlipKitVoicePool);
 	GDREGISTER_CLASS(BlipKitWaveform);
 
 	StringNames::create();
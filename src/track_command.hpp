@@ -0,0 +1,16 @@
+#pragma once
+
+#include <BlipKit.h>
+
+namespace BlipKit {
+
+class BlipKitTrack;
+
+struct TrackCommand {
+	BlipKitTrack *track = nullptr; // Tracks remove their commands when detaching.
+	BKEnum attribute = 0;
+	BKInt size = 0; // Number of values; `0` sets a single attribute value.
+	BKInt values[BK_MAX_ARPEGGIO + 1] = { 0 };
+};
+
+} // namespace BlipKit